@@ -0,0 +1,113 @@
+#include "Benchmark.h"
+
+#include "Util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+namespace coral {
+
+	static std::string escape_json(const std::string& text)
+	{
+		std::string out;
+		out.reserve(text.size());
+		for (char c : text) {
+			if (c == '"' || c == '\\') {
+				out += '\\';
+			}
+			out += c;
+		}
+		return out;
+	}
+
+	Benchmark::Benchmark(const Settings& settings)
+		: settings(settings)
+	{
+	}
+
+	void Benchmark::add_context(const std::string& key, const std::string& value)
+	{
+		context.emplace_back(key, value);
+	}
+
+	void Benchmark::record(const std::string& name, std::size_t iterations, std::vector<double> samples)
+	{
+		if (samples.empty()) {
+			Util::throw_exception("Benchmark recorded no samples", name.c_str());
+		}
+
+		Result result{};
+		result.name = name;
+		result.iterations = iterations;
+
+		double count = static_cast<double>(samples.size());
+		result.mean_ns = std::accumulate(samples.begin(), samples.end(), 0.0) / count;
+
+		double variance = 0.0;
+		for (double sample : samples) {
+			variance += (sample - result.mean_ns) * (sample - result.mean_ns);
+		}
+		result.stddev_ns = samples.size() > 1 ? std::sqrt(variance / (count - 1.0)) : 0.0;
+
+		std::sort(samples.begin(), samples.end());
+		std::size_t mid = samples.size() / 2;
+		result.median_ns = (samples.size() % 2 == 0) ? (samples[mid - 1] + samples[mid]) / 2.0 : samples[mid];
+		result.min_ns = samples.front();
+		result.max_ns = samples.back();
+
+		std::cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(14) << result.median_ns << " ns" << std::defaultfloat << '\n';
+
+		results.push_back(std::move(result));
+	}
+
+	void Benchmark::print() const
+	{
+		Util::print_divider("Benchmark Results");
+
+		std::cout << std::left << std::setw(36) << "Name" << std::right
+			<< std::setw(12) << "Iterations" << std::setw(14) << "Mean ns" << std::setw(14) << "Median ns"
+			<< std::setw(14) << "Stddev ns" << '\n';
+
+		std::cout << std::fixed << std::setprecision(1);
+		for (const Result& result : results) {
+			std::cout << std::left << std::setw(36) << result.name << std::right
+				<< std::setw(12) << result.iterations << std::setw(14) << result.mean_ns
+				<< std::setw(14) << result.median_ns << std::setw(14) << result.stddev_ns << '\n';
+		}
+		std::cout << std::defaultfloat;
+	}
+
+	void Benchmark::write_json(const std::string& filename) const
+	{
+		std::ofstream out(filename, std::ios::trunc);
+		if (!out.is_open()) {
+			Util::throw_exception("Failed to open benchmark report", filename.c_str());
+		}
+
+		out << "{\n  \"context\": {";
+		for (std::size_t i = 0; i < context.size(); ++i) {
+			out << (i == 0 ? "\n" : ",\n") << "    \"" << escape_json(context[i].first) << "\": \"" << escape_json(context[i].second) << '"';
+		}
+		out << "\n  },\n  \"benchmarks\": [";
+
+		out << std::setprecision(17);
+		for (std::size_t i = 0; i < results.size(); ++i) {
+			const Result& result = results[i];
+			out << (i == 0 ? "\n" : ",\n") << "    {"
+				<< "\"name\": \"" << escape_json(result.name) << "\", "
+				<< "\"iterations\": " << result.iterations << ", "
+				<< "\"mean_ns\": " << result.mean_ns << ", "
+				<< "\"median_ns\": " << result.median_ns << ", "
+				<< "\"stddev_ns\": " << result.stddev_ns << ", "
+				<< "\"min_ns\": " << result.min_ns << ", "
+				<< "\"max_ns\": " << result.max_ns << '}';
+		}
+		out << "\n  ]\n}\n";
+	}
+
+} // namespace coral
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace coral {
+
+	/// Minimal micro-benchmark runner. Each benchmark is run in batches sized so a single sample takes
+	/// at least the configured minimum time, then per-iteration statistics are computed across samples.
+	class Benchmark {
+	public:
+
+		struct Settings {
+			std::size_t sample_count = 30u;
+			double min_sample_seconds = 0.01;
+		};
+
+		struct Result {
+			std::string name;
+			std::size_t iterations;
+			double mean_ns;
+			double median_ns;
+			double stddev_ns;
+			double min_ns;
+			double max_ns;
+		};
+
+	private:
+
+		using Clock = std::chrono::steady_clock;
+
+		Settings settings;
+		std::vector<Result> results{};
+		std::vector<std::pair<std::string, std::string>> context{};
+
+		/// Called at the end of every sample before the clock stops, e.g. glFinish to include GPU work.
+		std::function<void()> sample_fence{};
+
+		static inline const void* volatile sink = nullptr;
+
+	public:
+
+		explicit Benchmark(const Settings& settings);
+
+		void set_sample_fence(std::function<void()> fence) { sample_fence = std::move(fence); }
+
+		/// Attach a key/value pair describing the environment, written to the JSON report.
+		void add_context(const std::string& key, const std::string& value);
+
+		template<typename F>
+		void run(const std::string& name, F&& fn)
+		{
+			// Warm up and find a batch size that fills the minimum sample time
+			std::size_t batch = 1u;
+			for (;;) {
+				double seconds = time_batch(fn, batch);
+				if (seconds >= settings.min_sample_seconds || batch >= (std::size_t(1) << 30)) {
+					break;
+				}
+				batch *= 2u;
+			}
+
+			std::vector<double> samples;
+			samples.reserve(settings.sample_count);
+			for (std::size_t i = 0; i < settings.sample_count; ++i) {
+				samples.push_back(time_batch(fn, batch) * 1.0e9 / static_cast<double>(batch));
+			}
+
+			record(name, batch * settings.sample_count, std::move(samples));
+		}
+
+		[[nodiscard]] const std::vector<Result>& get_results() const noexcept { return results; }
+
+		void print() const;
+
+		void write_json(const std::string& filename) const;
+
+		/// Prevent the compiler from discarding a computed value.
+		template<typename T>
+		static void keep(const T& value)
+		{
+			sink = &value;
+		}
+
+	private:
+
+		template<typename F>
+		double time_batch(F& fn, std::size_t batch)
+		{
+			Clock::time_point start = Clock::now();
+			for (std::size_t i = 0; i < batch; ++i) {
+				fn();
+			}
+			if (sample_fence) {
+				sample_fence();
+			}
+			return std::chrono::duration<double>(Clock::now() - start).count();
+		}
+
+		void record(const std::string& name, std::size_t iterations, std::vector<double> samples);
+
+	};
+
+} // namespace coral
@@ -0,0 +1,612 @@
+#include "Benchmark.h"
+
+#include "FileView.h"
+#include "Framebuffer.h"
+#include "FrustumCuller.h"
+#include "HeadlessContext.h"
+#include "MeshFile.h"
+#include "MeshImporter.h"
+#include "IndirectBatch.h"
+#include "MeshLod.h"
+#include "MeshOptimizer.h"
+#include "MeshPool.h"
+#include "MeshSimplifier.h"
+#include "MeshUtil.h"
+#include "MeshletBuilder.h"
+#include "Model.h"
+#include "ProgramBinaryCache.h"
+#include "ShaderCompiler.h"
+#include "ShaderUtil.h"
+#include "StreamBuffer.h"
+#include "UniformBlockApplication.h"
+#include "Util.h"
+#include "VertexBank.h"
+
+#include <glew/glew.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <sdl/SDL.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace coral;
+
+/// Size of the offscreen target every draw benchmark renders into. Small, so that draws covering it measure
+/// submission more than fill rate.
+static constexpr int FRAMEBUFFER_WIDTH = 256;
+static constexpr int FRAMEBUFFER_HEIGHT = 256;
+
+static void GLAPIENTRY gl_message_callback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam)
+{
+	bool is_error = type == GL_DEBUG_TYPE_ERROR;
+	std::ostream& output = (is_error ? std::cerr : std::cout);
+
+	output << "GL Callback: " << (is_error ? "** GL Error **" : "Non Error") << " - Severity: " << severity << '\n';
+	output << message << '\n';
+}
+
+struct BenchmarkOptions {
+	std::string shader_path = "../Working_Clean/shaders/";
+	std::string json_path{};
+	Benchmark::Settings settings{};
+};
+
+static BenchmarkOptions parse_options(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	for (int i = 1; i < argc; ++i) {
+		auto value = [&]() -> const char* {
+			if (i + 1 >= argc) {
+				Util::throw_exception("Missing value for option", argv[i]);
+			}
+			return argv[++i];
+		};
+
+		if (std::strcmp(argv[i], "--shaders") == 0) {
+			options.shader_path = value();
+		} else if (std::strcmp(argv[i], "--json") == 0) {
+			options.json_path = value();
+		} else if (std::strcmp(argv[i], "--samples") == 0) {
+			const char* samples = value();
+			options.settings.sample_count = std::stoul(samples);
+			if (options.settings.sample_count == 0u) {
+				// Statistics need at least one sample
+				Util::throw_exception("Sample count must be at least one", samples);
+			}
+		} else if (std::strcmp(argv[i], "--min-time") == 0) {
+			options.settings.min_sample_seconds = std::stod(value());
+		} else {
+			Util::throw_exception("Unknown option", argv[i]);
+		}
+	}
+
+	return options;
+}
+
+static void write_test_file(const std::string& filename, std::size_t size)
+{
+	std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+	std::string line = "// The quick brown fox jumps over the lazy dog 0123456789\n";
+	for (std::size_t written = 0; written < size; written += line.size()) {
+		out << line;
+	}
+}
+
+/// Grid of size x size vertices with one UV and normal per position, like a typical scan export.
+static void write_grid_obj(const std::string& filename, int size)
+{
+	std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+	char line[96];
+	for (int y = 0; y < size; ++y) {
+		for (int x = 0; x < size; ++x) {
+			float u = static_cast<float>(x) / size;
+			float v = static_cast<float>(y) / size;
+			out.write(line, std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn 0 0 1\n", u, v, u * v * 0.25f, u, v));
+		}
+	}
+	for (int y = 0; y + 1 < size; ++y) {
+		for (int x = 0; x + 1 < size; ++x) {
+			int a = y * size + x + 1;
+			int b = a + size;
+			out.write(line, std::snprintf(line, sizeof(line), "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, a + 1, a + 1, a + 1, b + 1, b + 1, b + 1, b, b, b));
+		}
+	}
+}
+
+static void run_benchmarks(Benchmark& bench, const BenchmarkOptions& options)
+{
+	Util::print_divider("Benchmarks Begin");
+
+	// ShaderUtil
+	{
+		for (const char* name : { "first", "model" }) {
+			std::string vert = options.shader_path + name + ".vert";
+			std::string frag = options.shader_path + name + ".frag";
+			bench.run(std::string("ShaderUtil::compile_shader/") + name, [&]() {
+				GLuint program = ShaderUtil::compile_shader(vert, frag, "Shader::Benchmark");
+				glDeleteProgram(program);
+			});
+		}
+
+		// Submit a batch of programs at once and collect them as they complete
+		{
+			static constexpr std::size_t BATCH = 8u;
+			std::string vert = options.shader_path + "first.vert";
+			std::string frag = options.shader_path + "first.frag";
+			ShaderCompiler compiler;
+			bench.run("ShaderCompiler/batch8", [&]() {
+				std::vector<ShaderCompiler::Handle> handles;
+				for (std::size_t i = 0; i < BATCH; ++i) {
+					handles.push_back(compiler.submit(vert, frag, "Shader::Benchmark"));
+				}
+				for (ShaderCompiler::Handle handle : handles) {
+					compiler.wait(handle);
+					glDeleteProgram(compiler.take(handle));
+				}
+			});
+		}
+
+		ProgramBinaryCache cache("benchmark_shader_cache");
+		if (cache.is_supported()) {
+			std::string vert = options.shader_path + "first.vert";
+			std::string frag = options.shader_path + "first.frag";
+			glDeleteProgram(ShaderUtil::compile_shader(vert, frag, "Shader::Benchmark", &cache));
+			bench.run("ShaderUtil::compile_shader/first/cached", [&]() {
+				GLuint program = ShaderUtil::compile_shader(vert, frag, "Shader::Benchmark", &cache);
+				glDeleteProgram(program);
+			});
+		}
+	}
+
+	// UniformBlockApplication
+	{
+		UniformBlockApplication block;
+		float time = 0.0f;
+		bench.run("UniformBlockApplication::update", [&]() {
+			time += 1.0f / 60.0f;
+			block.update(1280, 720, 640, 360, time, time);
+			block.end_frame();
+		});
+	}
+
+	// Model
+	{
+		MeshPool pool(1u << 16, 1u << 18, "MeshPool::Benchmark");
+		bench.run("Model::Model/RECT", [&]() {
+			Model model(pool, VertexBank::RECT.data(), static_cast<unsigned int>(VertexBank::RECT.size()));
+		});
+
+		Model model(pool, VertexBank::RECT.data(), static_cast<unsigned int>(VertexBank::RECT.size()));
+		GLuint program = ShaderUtil::compile_shader(options.shader_path + "first.vert", options.shader_path + "first.frag", "Shader::Benchmark");
+		glUseProgram(program);
+		pool.bind();
+		bench.run("Model::draw/RECT", [&]() {
+			model.draw();
+		});
+
+		std::vector<Model> models;
+		for (int i = 0; i < 1024; ++i) {
+			models.emplace_back(pool, VertexBank::RECT.data(), static_cast<unsigned int>(VertexBank::RECT.size()));
+		}
+		bench.run("Model::draw/RECT x1024", [&]() {
+			for (const Model& m : models) {
+				m.draw();
+			}
+		});
+		pool.unbind();
+		glUseProgram(0u);
+		glDeleteProgram(program);
+	}
+
+	// MeshUtil::weld on a triangle soup of 128x128 quads, six vertices each
+	{
+		std::vector<MeshPool::Vertex> soup;
+		for (int y = 0; y < 128; ++y) {
+			for (int x = 0; x < 128; ++x) {
+				glm::vec3 a{ x, y, 0.0f };
+				glm::vec3 b{ x + 1, y, 0.0f };
+				glm::vec3 c{ x, y + 1, 0.0f };
+				glm::vec3 d{ x + 1, y + 1, 0.0f };
+				for (const glm::vec3& position : { a, b, c, c, b, d }) {
+					soup.push_back(MeshPool::Vertex{ position });
+				}
+			}
+		}
+
+		bench.run("MeshUtil::weld/soup 128x128", [&]() {
+			IndexedMesh mesh = MeshUtil::weld(soup.data(), static_cast<std::uint32_t>(soup.size()));
+			Benchmark::keep(mesh);
+		});
+
+		// MeshOptimizer on the welded grid with its triangles shuffled, as they often arrive from exporters
+		IndexedMesh shuffled = MeshUtil::weld(soup.data(), static_cast<std::uint32_t>(soup.size()));
+		std::vector<std::uint32_t> order(shuffled.indices.size() / 3u);
+		std::iota(order.begin(), order.end(), 0u);
+		std::shuffle(order.begin(), order.end(), std::mt19937{ 1234u });
+		std::vector<MeshPool::Index> indices;
+		for (std::uint32_t triangle : order) {
+			indices.insert(indices.end(), shuffled.indices.begin() + triangle * 3u, shuffled.indices.begin() + triangle * 3u + 3u);
+		}
+		shuffled.indices = std::move(indices);
+
+		MeshOptimizer::Report report;
+		bench.run("MeshOptimizer::optimize/grid 128x128", [&]() {
+			IndexedMesh mesh = shuffled;
+			report = MeshOptimizer::optimize(mesh);
+			Benchmark::keep(mesh);
+		});
+		MeshOptimizer::print(report, "MeshOptimizer/grid 128x128");
+
+		// Compressing the grid to PackedVertex, with flat normals and UVs from the positions
+		std::vector<glm::vec3> normals(shuffled.vertices.size(), glm::vec3{ 0.0f, 0.0f, 1.0f });
+		std::vector<glm::vec2> uvs;
+		for (const MeshPool::Vertex& vertex : shuffled.vertices) {
+			uvs.push_back(glm::vec2{ vertex.position.x, vertex.position.y } / 128.0f);
+		}
+		bench.run("MeshUtil::pack/grid 128x128", [&]() {
+			PackedMesh packed = MeshUtil::pack(shuffled, normals.data(), uvs.data());
+			Benchmark::keep(packed);
+		});
+		std::cout << "MeshUtil::pack/grid 128x128: " << sizeof(glm::vec3) * 2u + sizeof(glm::vec2) + sizeof(glm::vec4) << " -> " << sizeof(PackedVertex) << " bytes per vertex\n";
+
+		// Loading the optimized grid from a cooked mesh file against uploading it from memory
+		static const std::string MESH_FILE_PATH = "benchmark_grid.cmesh";
+		IndexedMesh optimized = shuffled;
+		MeshOptimizer::optimize(optimized);
+		MeshFile::write(MESH_FILE_PATH, optimized);
+
+		MeshPool pool(1u << 16, 1u << 18, "MeshPool::Benchmark");
+		bench.run("Model::Model/IndexedMesh grid 128x128", [&]() {
+			Model model(pool, optimized, GL_TRIANGLES, false);
+		});
+		bench.run("Model::Model/MeshFile grid 128x128", [&]() {
+			Model model(pool, MeshFile(MESH_FILE_PATH));
+		});
+		std::remove(MESH_FILE_PATH.c_str());
+	}
+
+	// MeshSimplifier on a bumpy 128x128 heightfield, and choosing levels for many objects at once
+	{
+		IndexedMesh terrain;
+		for (int y = 0; y <= 128; ++y) {
+			for (int x = 0; x <= 128; ++x) {
+				float height = 2.0f * std::sin(x * 0.1f) * std::cos(y * 0.13f) + 0.5f * std::sin(x * 0.37f + y * 0.29f);
+				terrain.vertices.push_back(MeshPool::Vertex{ glm::vec3{ x, y, height } });
+			}
+		}
+		for (MeshPool::Index y = 0u; y < 128u; ++y) {
+			for (MeshPool::Index x = 0u; x < 128u; ++x) {
+				MeshPool::Index a = y * 129u + x;
+				MeshPool::Index c = a + 129u;
+				terrain.indices.insert(terrain.indices.end(), { a, a + 1u, c, c, a + 1u, c + 1u });
+			}
+		}
+
+		LodChain chain;
+		bench.run("MeshSimplifier::build_lod_chain/heightfield 128x128", [&]() {
+			chain = MeshSimplifier::build_lod_chain(terrain);
+		});
+		for (std::size_t i = 0u; i < chain.levels.size(); ++i) {
+			std::cout << "MeshSimplifier/heightfield 128x128: LOD " << i << " has " << chain.levels[i].index_count / 3u << " triangles, error "
+				<< chain.levels[i].error << '\n';
+		}
+
+		// Splitting every level into meshlets, then testing their cones from cameras all around the heightfield
+		std::vector<Meshlet> meshlets;
+		bench.run("MeshletBuilder::build/heightfield 128x128 LODs", [&]() {
+			IndexedMesh clustered = chain.mesh;
+			meshlets = MeshletBuilder::build(clustered, chain.levels);
+		});
+		std::cout << "MeshletBuilder/heightfield 128x128 LODs: " << meshlets.size() << " meshlets, "
+			<< chain.mesh.indices.size() / 3u / meshlets.size() << " triangles each on average\n";
+
+		std::vector<glm::vec3> cameras;
+		for (int i = 0; i < 64; ++i) {
+			float angle = i * 0.1f;
+			cameras.push_back(glm::vec3{ 64.0f + 200.0f * std::cos(angle), 64.0f + 200.0f * std::sin(angle), 150.0f * std::sin(i * 0.37f) });
+		}
+		std::size_t backfacing = 0u;
+		bench.run("Meshlet::is_backfacing/64 cameras", [&]() {
+			backfacing = 0u;
+			for (const glm::vec3& camera : cameras) {
+				for (const Meshlet& meshlet : meshlets) {
+					backfacing += meshlet.is_backfacing(camera) ? 1u : 0u;
+				}
+			}
+		});
+		std::cout << "Meshlet/heightfield 128x128 LODs: " << 100u * backfacing / (cameras.size() * meshlets.size()) << "% culled by cones\n";
+
+		std::vector<float> distances(65536u);
+		std::mt19937 random{ 1234u };
+		std::uniform_real_distribution<float> distance(1.0f, 2000.0f);
+		std::generate(distances.begin(), distances.end(), [&]() { return distance(random); });
+		LodSelector selector = LodSelector::perspective(1.0f, 1080.0f);
+		bench.run("LodSelector::select/65536", [&]() {
+			std::size_t sum = 0u;
+			for (float d : distances) {
+				sum += selector.select(chain.levels.data(), chain.levels.size(), d);
+			}
+			Benchmark::keep(sum);
+		});
+	}
+
+	// MeshImporter on a 512x512 grid OBJ, with one worker against one per hardware thread
+	{
+		static const std::string OBJ_PATH = "benchmark_grid.obj";
+		write_grid_obj(OBJ_PATH, 512);
+
+		MeshImporter single(1u);
+		bench.run("MeshImporter::import_obj/grid 512x512/1 worker", [&]() {
+			ImportedMesh mesh = single.import_obj(OBJ_PATH);
+			Benchmark::keep(mesh);
+		});
+		MeshImporter importer;
+		bench.run("MeshImporter::import_obj/grid 512x512/" + std::to_string(importer.get_concurrency() - 1u) + " workers", [&]() {
+			ImportedMesh mesh = importer.import_obj(OBJ_PATH);
+			Benchmark::keep(mesh);
+		});
+		std::remove(OBJ_PATH.c_str());
+
+		// The float parser alone against strtof on the same text
+		std::string numbers;
+		for (int i = 0; i < 4096; ++i) {
+			numbers += std::to_string(std::sin(i * 0.37) * 100.0) + ' ';
+		}
+		bench.run("MeshImporter::parse_float/4096", [&]() {
+			float sum = 0.0f;
+			for (const char* p = numbers.data(); p < numbers.data() + numbers.size(); ++p) {
+				float value;
+				p = MeshImporter::parse_float(p, numbers.data() + numbers.size(), value);
+				sum += value;
+			}
+			Benchmark::keep(sum);
+		});
+		bench.run("strtof/4096", [&]() {
+			float sum = 0.0f;
+			for (const char* p = numbers.data(); p < numbers.data() + numbers.size(); ++p) {
+				char* end;
+				sum += std::strtof(p, &end);
+				p = end;
+			}
+			Benchmark::keep(sum);
+		});
+	}
+
+	// FrustumCuller on 100k and 1M boxes scattered over a plane, seen by a perspective camera, with every kernel
+	{
+		glm::mat4 view_projection = glm::perspective(1.0f, 16.0f / 9.0f, 0.1f, 500.0f)
+			* glm::lookAt(glm::vec3{ 0.0f, 20.0f, 0.0f }, glm::vec3{ 100.0f, 0.0f, 100.0f }, glm::vec3{ 0.0f, 1.0f, 0.0f });
+		Frustum frustum = Frustum::from_matrix(view_projection);
+
+		for (std::size_t object_count : { std::size_t{ 100000u }, std::size_t{ 1000000u } }) {
+			FrustumCuller culler;
+			culler.reserve(object_count);
+			std::mt19937 random{ 1234u };
+			std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+			std::uniform_real_distribution<float> size(0.5f, 4.0f);
+			for (std::size_t i = 0u; i < object_count; ++i) {
+				glm::vec3 center{ position(random), size(random), position(random) };
+				glm::vec3 extent{ size(random), center.y, size(random) };
+				culler.add(center - extent, center + extent, glm::length(extent) * 0.8f);
+			}
+
+			FrustumCuller::IndexList visible;
+			std::string label = "FrustumCuller::cull/" + std::to_string(object_count / 1000u) + "k/";
+			for (FrustumCuller::Kernel kernel : { FrustumCuller::Kernel::SCALAR, FrustumCuller::Kernel::SSE, FrustumCuller::Kernel::AVX2 }) {
+				if (!FrustumCuller::is_supported(kernel)) {
+					continue;
+				}
+				culler.set_kernel(kernel);
+				bench.run(label + FrustumCuller::get_name(kernel), [&]() {
+					culler.cull(frustum, visible);
+				});
+				const Benchmark::Result& result = bench.get_results().back();
+				std::cout << result.name << ": " << visible.size() << " visible, " << static_cast<std::uint64_t>(object_count / (result.median_ns * 1.0e-9)) << " objects/s\n";
+			}
+		}
+	}
+
+	// Draw submission: one call per Model against one multi-draw-indirect call per pool page and one instanced call
+	{
+		static constexpr std::uint32_t OBJECT_COUNT = 4096u;
+
+		struct ObjectData {
+			glm::vec4 transform;
+			glm::vec4 color;
+		};
+
+		MeshPool pool(1u << 16, 1u << 18, "MeshPool::Benchmark");
+		std::vector<Model> models;
+		std::vector<MeshPool::Mesh> indexed;
+		std::vector<ObjectData> objects;
+		for (std::uint32_t i = 0u; i < OBJECT_COUNT; ++i) {
+			models.emplace_back(pool, VertexBank::RECT.data(), static_cast<unsigned int>(VertexBank::RECT.size()));
+			indexed.push_back(pool.add(VertexBank::RECT.data(), static_cast<std::uint32_t>(VertexBank::RECT.size()),
+				VertexBank::RECT_INDICES.data(), static_cast<std::uint32_t>(VertexBank::RECT_INDICES.size())));
+
+			// Tiny quads keep rasterization out of the measurement
+			float x = (i % 64u) / 32.0f - 1.0f;
+			float y = (i / 64u) / 32.0f - 1.0f;
+			objects.push_back(ObjectData{ glm::vec4{ x, y, 0.001f, 0.001f }, glm::vec4{ 1.0f } });
+		}
+
+		GLuint object_buffer = 0u;
+		glGenBuffers(1, &object_buffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, object_buffer);
+		glBufferStorage(GL_SHADER_STORAGE_BUFFER, sizeof(ObjectData) * objects.size(), objects.data(), 0);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0u);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1u, object_buffer);
+
+		GLuint program = ShaderUtil::compile_shader(options.shader_path + "batch.vert", options.shader_path + "batch.frag", "Shader::Benchmark");
+		glUseProgram(program);
+		pool.bind();
+
+		IndirectBatch batch(OBJECT_COUNT, "IndirectBatch::Benchmark");
+		auto run_batch = [&](const char* name, GLenum mode, auto&& mesh_at) {
+			bench.run(name, [&]() {
+				batch.begin_frame();
+				for (std::uint32_t i = 0u; i < OBJECT_COUNT; ++i) {
+					batch.add(mesh_at(i), i);
+				}
+				batch.submit(pool, mode);
+				batch.end_frame();
+			});
+		};
+
+		bench.run("Draw/Model::draw x4096", [&]() {
+			for (const Model& model : models) {
+				model.draw();
+			}
+		});
+		run_batch("Draw/IndirectBatch/arrays x4096", GL_TRIANGLE_STRIP, [&](std::uint32_t i) { return models[i].get_mesh(); });
+
+		bench.run("Draw/MeshPool::draw/indexed x4096", [&]() {
+			for (const MeshPool::Mesh& mesh : indexed) {
+				pool.draw(mesh, GL_TRIANGLES);
+			}
+		});
+		run_batch("Draw/IndirectBatch/elements x4096", GL_TRIANGLES, [&](std::uint32_t i) { return indexed[i]; });
+
+		// One instanced call, streaming the instance data every time
+		GLuint sprite_program = ShaderUtil::compile_shader(options.shader_path + "sprite.vert", options.shader_path + "sprite.frag", "Shader::Benchmark");
+		glUseProgram(sprite_program);
+
+		std::vector<Model::Instance> instances;
+		for (const ObjectData& object : objects) {
+			// The same placement as the batch shader's offset and scale
+			glm::mat4 transform = glm::translate(glm::mat4{ 1.0f }, glm::vec3{ object.transform.x, object.transform.y, 0.0f });
+			transform = glm::scale(transform, glm::vec3{ object.transform.z, object.transform.w, 1.0f });
+			instances.push_back(Model::Instance{ transform, object.color, glm::vec4{ 0.0f } });
+		}
+		StreamBuffer stream(sizeof(Model::Instance) * OBJECT_COUNT, "StreamBuffer::Benchmark");
+		bench.run("Draw/Model::draw_instanced x4096", [&]() {
+			stream.begin_frame();
+			models[0].draw_instanced(stream, instances.data(), OBJECT_COUNT);
+			stream.end_frame();
+		});
+
+		// Express the last five results as object throughput
+		const std::vector<Benchmark::Result>& results = bench.get_results();
+		for (std::size_t i = results.size() - 5u; i < results.size(); ++i) {
+			double objects_per_second = OBJECT_COUNT / (results[i].median_ns * 1.0e-9);
+			std::cout << results[i].name << ": " << static_cast<std::uint64_t>(objects_per_second) << " objects/s\n";
+		}
+
+		pool.unbind();
+		glUseProgram(0u);
+		glDeleteProgram(program);
+		glDeleteProgram(sprite_program);
+		glDeleteBuffers(1, &object_buffer);
+	}
+
+	// Util::read_file
+	{
+		std::string small_path = options.shader_path + "first.frag";
+		bench.run("Util::read_file/small", [&]() {
+			std::string text = Util::read_file(small_path);
+			Benchmark::keep(text);
+		});
+
+		static const std::string LARGE_PATH = "benchmark_large.tmp";
+		write_test_file(LARGE_PATH, 16u << 20);
+		bench.run("Util::read_file/16MiB", [&]() {
+			std::string text = Util::read_file(LARGE_PATH);
+			Benchmark::keep(text);
+		});
+
+		bench.run("FileView/small", [&]() {
+			FileView view(small_path);
+			Benchmark::keep(view);
+		});
+
+		// Touch every page so the cost of faulting in the mapping is included
+		bench.run("FileView/16MiB", [&]() {
+			FileView view(LARGE_PATH, FileAccess::SEQUENTIAL);
+			unsigned int sum = 0u;
+			for (std::size_t i = 0; i < view.get_size(); i += 4096u) {
+				sum += static_cast<unsigned char>(view.get_data()[i]);
+			}
+			Benchmark::keep(sum);
+		});
+		std::remove(LARGE_PATH.c_str());
+	}
+
+	Util::print_divider("Benchmarks End");
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+	try {
+		options = parse_options(argc, argv);
+	} catch (std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::cerr << "Usage: Benchmark [--shaders dir/] [--json report.json] [--samples N] [--min-time seconds]\n";
+		return 1;
+	}
+
+	SDL_Init(SDL_INIT_TIMER);
+
+	try {
+		HeadlessContext context;
+
+		GLenum glew_status = glewInit();
+		if (glew_status != GLEW_OK && glew_status != GLEW_ERROR_NO_GLX_DISPLAY) {
+			throw std::runtime_error("GLEW failed to init");
+		}
+
+		glEnable(GL_DEBUG_OUTPUT);
+		glDebugMessageCallback(gl_message_callback, nullptr);
+		glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE); // no notifications
+
+		// There is no default framebuffer without a window, so draws would fail and measure nothing
+		Framebuffer framebuffer(FRAMEBUFFER_WIDTH, FRAMEBUFFER_HEIGHT, "Framebuffer::Benchmark");
+		framebuffer.bind();
+		glViewport(0, 0, FRAMEBUFFER_WIDTH, FRAMEBUFFER_HEIGHT);
+
+		Benchmark bench(options.settings);
+		bench.set_sample_fence([]() {
+			glFinish();
+			// A sample that raised a GL error timed the error, not the work
+			GLenum error = glGetError();
+			if (error != GL_NO_ERROR) {
+				char code[16];
+				std::snprintf(code, sizeof(code), "0x%04X", error);
+				Util::throw_exception("GL error during benchmark sample", code);
+			}
+		});
+		bench.add_context("gl_vendor", reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+		bench.add_context("gl_renderer", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+		bench.add_context("gl_version", reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+
+		run_benchmarks(bench, options);
+
+		bench.print();
+		if (!options.json_path.empty()) {
+			bench.write_json(options.json_path);
+			std::cout << "Wrote report to " << options.json_path << '\n';
+		}
+	} catch (std::exception& e) {
+		std::cerr << "Benchmark panicked:\n" << e.what() << '\n';
+		SDL_Quit();
+		return 1;
+	}
+
+	SDL_Quit();
+	return 0;
+}
@@ -0,0 +1,165 @@
+#include "MeshFile.h"
+#include "MeshImporter.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshUtil.h"
+#include "MeshletBuilder.h"
+
+#include <glm/geometric.hpp>
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace coral;
+
+struct CookerOptions {
+	std::string input_path{};
+	std::string output_path{};
+	/// Write PackedVertex instead of float positions.
+	bool packed = false;
+	bool optimize = true;
+	/// Also write simplified levels of detail.
+	bool lods = false;
+	LodSettings lod_settings{};
+	/// Also split each level into meshlets for culling.
+	bool meshlets = false;
+};
+
+static CookerOptions parse_options(int argc, char** argv)
+{
+	CookerOptions options;
+
+	std::vector<std::string> paths;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--packed") == 0) {
+			options.packed = true;
+		} else if (std::strcmp(argv[i], "--no-optimize") == 0) {
+			options.optimize = false;
+			options.lod_settings.optimize = false;
+		} else if (std::strcmp(argv[i], "--meshlets") == 0) {
+			options.meshlets = true;
+		} else if (std::strcmp(argv[i], "--lods") == 0) {
+			options.lods = true;
+		} else if (std::strcmp(argv[i], "--lod-errors") == 0) {
+			if (i + 1 >= argc) {
+				throw std::runtime_error("Missing value for --lod-errors");
+			}
+			// Comma separated, relative to the mesh's bounding radius
+			options.lods = true;
+			options.lod_settings.target_errors.clear();
+			std::istringstream list(argv[++i]);
+			for (std::string value; std::getline(list, value, ',');) {
+				options.lod_settings.target_errors.push_back(std::stof(value));
+			}
+		} else if (argv[i][0] == '-') {
+			throw std::runtime_error(std::string("Unknown option: ") + argv[i]);
+		} else {
+			paths.push_back(argv[i]);
+		}
+	}
+
+	if (paths.size() != 2u) {
+		throw std::runtime_error("Expected an input and an output path");
+	}
+	options.input_path = paths[0];
+	options.output_path = paths[1];
+	return options;
+}
+
+/// Face normals of the first index_count indices accumulated onto vertices that came without one.
+static void fill_normals(ImportedMesh& source, std::size_t index_count)
+{
+	source.normals.resize(source.mesh.vertices.size(), glm::vec3{ 0.0f });
+
+	std::vector<glm::vec3> accumulated(source.normals.size(), glm::vec3{ 0.0f });
+	const std::vector<MeshPool::Index>& indices = source.mesh.indices;
+	for (std::size_t i = 0u; i + 2u < index_count; i += 3u) {
+		const glm::vec3& a = source.mesh.vertices[indices[i]].position;
+		const glm::vec3& b = source.mesh.vertices[indices[i + 1u]].position;
+		const glm::vec3& c = source.mesh.vertices[indices[i + 2u]].position;
+		glm::vec3 normal = glm::cross(b - a, c - a);
+		for (std::size_t k = 0u; k < 3u; ++k) {
+			accumulated[indices[i + k]] += normal;
+		}
+	}
+
+	for (std::size_t i = 0u; i < source.normals.size(); ++i) {
+		if (source.normals[i] == glm::vec3{ 0.0f }) {
+			source.normals[i] = accumulated[i] != glm::vec3{ 0.0f } ? accumulated[i] : glm::vec3{ 0.0f, 0.0f, 1.0f };
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	CookerOptions options;
+	try {
+		options = parse_options(argc, argv);
+	} catch (std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::cerr << "Usage: MeshCooker input.(obj|gltf|glb) output.cmesh [--packed] [--no-optimize] [--lods] [--lod-errors e1,e2,...] [--meshlets]\n";
+		return 1;
+	}
+
+	try {
+		MeshImporter importer;
+		ImportedMesh source = importer.import(options.input_path);
+		std::cout << options.input_path << ": " << source.mesh.vertices.size() << " vertices, " << source.mesh.indices.size() / 3u << " triangles\n";
+
+		// Reordering drops and moves vertices, so the other attributes follow their source vertex
+		std::vector<MeshPool::Index> sources;
+		std::vector<LodLevel> lods;
+		if (options.lods) {
+			LodChain chain = MeshSimplifier::build_lod_chain(source.mesh, options.lod_settings, &sources);
+			source.mesh = std::move(chain.mesh);
+			lods = std::move(chain.levels);
+			for (std::size_t i = 0u; i < lods.size(); ++i) {
+				std::cout << "LOD " << i << ": " << lods[i].index_count / 3u << " triangles, error " << std::setprecision(4) << lods[i].error << '\n';
+			}
+		} else if (options.optimize) {
+			MeshOptimizer::print(MeshOptimizer::optimize(source.mesh, &sources), "MeshOptimizer");
+		}
+
+		if (!sources.empty()) {
+			std::vector<glm::vec3> normals;
+			std::vector<glm::vec2> uvs;
+			for (MeshPool::Index index : sources) {
+				if (!source.normals.empty()) {
+					normals.push_back(source.normals[index]);
+				}
+				if (!source.uvs.empty()) {
+					uvs.push_back(source.uvs[index]);
+				}
+			}
+			source.normals = std::move(normals);
+			source.uvs = std::move(uvs);
+		}
+
+		// Only moves triangles within each level, so the vertices and levels stay as they are
+		std::vector<Meshlet> meshlets;
+		if (options.meshlets) {
+			meshlets = lods.empty() ? MeshletBuilder::build(source.mesh) : MeshletBuilder::build(source.mesh, lods);
+			std::cout << meshlets.size() << " meshlets, " << std::setprecision(4) << static_cast<float>(source.mesh.indices.size() / 3u) / meshlets.size()
+				<< " triangles each on average\n";
+		}
+
+		if (options.packed) {
+			fill_normals(source, lods.empty() ? source.mesh.indices.size() : lods[0].index_count);
+			MeshFile::write(options.output_path, MeshUtil::pack(source.mesh, source.normals.data(), source.uvs.empty() ? nullptr : source.uvs.data()), lods, meshlets);
+		} else {
+			MeshFile::write(options.output_path, source.mesh, lods, meshlets);
+		}
+	} catch (std::exception& e) {
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+
+	std::cout << "Wrote " << options.output_path << '\n';
+	return 0;
+}
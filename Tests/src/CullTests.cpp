@@ -0,0 +1,124 @@
+#include "Test.h"
+
+#include "FrustumCuller.h"
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace coral {
+
+	struct CullObject {
+		glm::vec3 min;
+		glm::vec3 max;
+		float radius;
+	};
+
+	/// How far inside the frustum an object reaches, in double precision: negative when it is wholly outside
+	/// a plane, by the same test as the kernels.
+	static double get_margin(const Frustum& frustum, const CullObject& object)
+	{
+		double margin = std::numeric_limits<double>::infinity();
+		for (const glm::vec4& plane : frustum.planes) {
+			double distance = 0.0;
+			double box = 0.0;
+			for (int axis = 0; axis < 3; ++axis) {
+				double center = (static_cast<double>(object.min[axis]) + object.max[axis]) * 0.5;
+				double extent = (static_cast<double>(object.max[axis]) - object.min[axis]) * 0.5;
+				distance += center * plane[axis];
+				box += extent * std::abs(static_cast<double>(plane[axis]));
+			}
+			margin = std::min(margin, distance + plane.w + std::min(box, static_cast<double>(object.radius)));
+		}
+		return margin;
+	}
+
+	/// Objects scattered across the frustum's edges, so many straddle a plane, but none so close to touching
+	/// one that rounding could decide it.
+	static std::vector<CullObject> make_objects(const Frustum& frustum, std::size_t count, unsigned int seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> position(-12.0f, 12.0f);
+		std::uniform_real_distribution<float> depth(-60.0f, 5.0f);
+		std::uniform_real_distribution<float> size(0.0f, 3.0f);
+		std::uniform_int_distribution<int> sphere_kind(0, 2);
+
+		std::vector<CullObject> objects;
+		while (objects.size() < count) {
+			glm::vec3 center{ position(random), position(random), depth(random) };
+			glm::vec3 extent{ size(random), size(random), size(random) };
+			// Box only, a sphere tighter than the box's corners, or one too small to hold the box
+			int kind = sphere_kind(random);
+			float radius = kind == 0 ? std::numeric_limits<float>::infinity() : glm::length(extent) * (kind == 1 ? 0.8f : 0.3f);
+			CullObject object{ center - extent, center + extent, radius };
+			if (std::abs(get_margin(frustum, object)) > 1e-3) {
+				objects.push_back(object);
+			}
+		}
+		return objects;
+	}
+
+	static void check_kernels(const Frustum& frustum, std::size_t count)
+	{
+		std::vector<CullObject> objects = make_objects(frustum, count, static_cast<unsigned int>(count));
+		FrustumCuller culler;
+		std::vector<std::uint32_t> expected;
+		for (const CullObject& object : objects) {
+			std::uint32_t index = culler.add(object.min, object.max, object.radius);
+			if (get_margin(frustum, object) >= 0.0) {
+				expected.push_back(index);
+			}
+		}
+
+		// The list is reused, as between frames, starting longer than any result so stale entries would show
+		FrustumCuller::IndexList visible(count + FrustumCuller::LANES, std::numeric_limits<std::uint32_t>::max());
+		for (FrustumCuller::Kernel kernel : { FrustumCuller::Kernel::SCALAR, FrustumCuller::Kernel::SSE, FrustumCuller::Kernel::AVX2 }) {
+			if (!FrustumCuller::is_supported(kernel)) {
+				continue;
+			}
+			culler.set_kernel(kernel);
+			std::size_t written = culler.cull(frustum, visible);
+			TEST_CHECK(written == visible.size());
+			TEST_CHECK(std::equal(visible.begin(), visible.end(), expected.begin(), expected.end()));
+		}
+	}
+
+	static void check_kernels(const char* name, const Frustum& frustum)
+	{
+		// Counts around the widths of the kernels' steps, so the padding objects are exercised
+		for (std::size_t count : { 0u, 1u, 3u, 4u, 7u, 8u, 9u, 13u, 1001u }) {
+			std::string label = std::string("Kernels match a double precision reference (") + name + ", " + std::to_string(count) + " objects)";
+			Test::run(label.c_str(), [&]() { check_kernels(frustum, count); });
+		}
+	}
+
+	void run_cull_tests()
+	{
+		glm::mat4 view_projection = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.5f, 50.0f)
+			* glm::lookAt(glm::vec3{ 0.0f, 0.0f, 5.0f }, glm::vec3{ 0.0f }, glm::vec3{ 0.0f, 1.0f, 0.0f });
+		check_kernels("perspective", Frustum::from_matrix(view_projection));
+		check_kernels("orthographic", Frustum::from_matrix(glm::ortho(-8.0f, 8.0f, -4.0f, 4.0f, 1.0f, 40.0f)));
+
+		Test::run("Only supported kernels can be chosen", []() {
+			FrustumCuller culler;
+			for (FrustumCuller::Kernel kernel : { FrustumCuller::Kernel::SCALAR, FrustumCuller::Kernel::SSE, FrustumCuller::Kernel::AVX2 }) {
+				bool thrown = false;
+				try {
+					culler.set_kernel(kernel);
+				} catch (const std::invalid_argument&) {
+					thrown = true;
+				}
+				TEST_CHECK(thrown != FrustumCuller::is_supported(kernel));
+			}
+		});
+	}
+
+} // namespace coral
@@ -0,0 +1,167 @@
+#include "Test.h"
+#include "TestMeshes.h"
+
+#include "MeshLod.h"
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace coral {
+
+	/// Every index addresses a vertex and no triangle repeats a vertex.
+	static void check_triangles(const IndexedMesh& mesh, std::size_t first_index, std::size_t index_count)
+	{
+		TEST_CHECK(index_count % 3u == 0u);
+		TEST_CHECK(first_index + index_count <= mesh.indices.size());
+
+		std::size_t out_of_range = 0u;
+		std::size_t degenerate = 0u;
+		for (std::size_t i = first_index; i + 2u < first_index + index_count; i += 3u) {
+			MeshPool::Index a = mesh.indices[i], b = mesh.indices[i + 1u], c = mesh.indices[i + 2u];
+			out_of_range += a >= mesh.vertices.size() || b >= mesh.vertices.size() || c >= mesh.vertices.size();
+			degenerate += a == b || b == c || c == a;
+		}
+		TEST_CHECK(out_of_range == 0u);
+		TEST_CHECK(degenerate == 0u);
+	}
+
+	/// With no ratio limit every target error gets a level, so each can be checked against its own bound.
+	static void check_chain_errors(const IndexedMesh& mesh)
+	{
+		LodSettings settings;
+		settings.max_triangle_ratio = 1.0f;
+		LodChain chain = MeshSimplifier::build_lod_chain(mesh, settings);
+		float radius = MeshSimplifier::get_radius(mesh);
+
+		TEST_CHECK(chain.levels.size() == settings.target_errors.size() + 1u);
+		TEST_CHECK(chain.mesh.vertices.size() == mesh.vertices.size());
+		TEST_CHECK(chain.levels[0].first_index == 0u && chain.levels[0].index_count == mesh.indices.size() && chain.levels[0].error == 0.0f);
+
+		for (std::size_t i = 1u; i < chain.levels.size(); ++i) {
+			const LodLevel& level = chain.levels[i];
+			const LodLevel& previous = chain.levels[i - 1u];
+			TEST_CHECK(level.error <= settings.target_errors[i - 1u] * radius);
+			TEST_CHECK(level.error >= previous.error);
+			TEST_CHECK(level.index_count <= previous.index_count);
+			TEST_CHECK(level.first_index == previous.first_index + previous.index_count);
+			check_triangles(chain.mesh, level.first_index, level.index_count);
+		}
+		TEST_CHECK(chain.levels.back().index_count < mesh.indices.size() / 4u);
+	}
+
+	/// Levels that would keep too many of the previous level's triangles are left out.
+	static void check_chain_ratio(const IndexedMesh& mesh)
+	{
+		LodSettings settings;
+		LodChain chain = MeshSimplifier::build_lod_chain(mesh, settings);
+		float radius = MeshSimplifier::get_radius(mesh);
+
+		TEST_CHECK(chain.levels.size() > 1u);
+		for (std::size_t i = 1u; i < chain.levels.size(); ++i) {
+			const LodLevel& level = chain.levels[i];
+			TEST_CHECK(static_cast<float>(level.index_count) <= static_cast<float>(chain.levels[i - 1u].index_count) * settings.max_triangle_ratio);
+			TEST_CHECK(level.error <= settings.target_errors.back() * radius);
+			check_triangles(chain.mesh, level.first_index, level.index_count);
+		}
+	}
+
+	/// Without optimization vertices stay in place and the full level is the source triangle list.
+	static void check_chain_unoptimized(const IndexedMesh& mesh)
+	{
+		LodSettings settings;
+		settings.optimize = false;
+		std::vector<MeshPool::Index> sources;
+		LodChain chain = MeshSimplifier::build_lod_chain(mesh, settings, &sources);
+
+		TEST_CHECK(sources.size() == mesh.vertices.size());
+		bool identity = true;
+		for (std::size_t i = 0u; i < sources.size(); ++i) {
+			identity = identity && sources[i] == i;
+		}
+		TEST_CHECK(identity);
+		TEST_CHECK(std::equal(mesh.indices.begin(), mesh.indices.end(), chain.mesh.indices.begin()));
+		TEST_CHECK(chain.levels.size() > 1u);
+		for (const LodLevel& level : chain.levels) {
+			check_triangles(chain.mesh, level.first_index, level.index_count);
+		}
+	}
+
+	static void check_simplify(const IndexedMesh& mesh)
+	{
+		// Unbounded error: the triangle count target is what stops it
+		std::size_t target_count = mesh.indices.size() / 4u;
+		float error = -1.0f;
+		std::vector<MeshPool::Index> indices = MeshSimplifier::simplify(mesh, target_count, 1e9f, &error);
+		TEST_CHECK(indices.size() <= target_count);
+		TEST_CHECK(error >= 0.0f);
+
+		IndexedMesh simplified{ mesh.vertices, indices };
+		check_triangles(simplified, 0u, indices.size());
+
+		// Bounded error: collapses stop before exceeding it, however far the count target is
+		float bound = 0.01f * MeshSimplifier::get_radius(mesh);
+		indices = MeshSimplifier::simplify(mesh, 0u, bound, &error);
+		TEST_CHECK(error <= bound);
+		TEST_CHECK(indices.size() < mesh.indices.size());
+		TEST_CHECK(!indices.empty());
+
+		// Zero error allows only collapses that change nothing, which a curved surface has none of
+		indices = MeshSimplifier::simplify(mesh, 0u, 0.0f, &error);
+		TEST_CHECK(error == 0.0f);
+	}
+
+	static void check_selector()
+	{
+		const std::vector<LodLevel> levels{
+			{ 0u, 3000u, 0.0f },
+			{ 3000u, 1200u, 0.001f },
+			{ 4200u, 300u, 0.01f },
+			{ 4500u, 60u, 0.1f },
+		};
+		LodSelector selector = LodSelector::perspective(1.0f, 1080.0f);
+
+		TEST_CHECK(selector.select(levels.data(), levels.size(), 0.0f) == 0u);
+		TEST_CHECK(selector.select(levels.data(), levels.size(), 1e6f) == levels.size() - 1u);
+		TEST_CHECK(selector.select(levels.data(), 0u, 10.0f) == 0u);
+
+		// Moving away never picks a finer level, and the level picked never shows more than the threshold
+		std::size_t previous = 0u;
+		bool reached_every_level[4] = { false, false, false, false };
+		for (float distance = 0.01f; distance < 1e4f; distance *= 1.1f) {
+			std::size_t selected = selector.select(levels.data(), levels.size(), distance);
+			TEST_CHECK(selected >= previous);
+			TEST_CHECK(selected == 0u || selector.project(levels[selected].error, distance) <= 1.0f);
+			TEST_CHECK(selected + 1u == levels.size() || selector.project(levels[selected + 1u].error, distance) > 1.0f);
+			reached_every_level[selected] = true;
+			previous = selected;
+		}
+		TEST_CHECK(reached_every_level[0] && reached_every_level[1] && reached_every_level[2] && reached_every_level[3]);
+
+		// Scaling an object up has the same effect as bringing it closer
+		TEST_CHECK(selector.select(levels.data(), levels.size(), 10.0f, 4.0f) == selector.select(levels.data(), levels.size(), 2.5f));
+
+		// Orthographic cameras ignore distance, and coarsen as the view shrinks on screen
+		LodSelector large = LodSelector::orthographic(2.0f, 1080.0f);
+		LodSelector small = LodSelector::orthographic(2.0f, 20.0f);
+		TEST_CHECK(large.select(levels.data(), levels.size(), 1.0f) == large.select(levels.data(), levels.size(), 1000.0f));
+		TEST_CHECK(small.select(levels.data(), levels.size(), 0.0f) > large.select(levels.data(), levels.size(), 0.0f));
+	}
+
+	void run_lod_tests()
+	{
+		IndexedMesh sphere = TestMeshes::make_sphere(4u, 0.01f);
+		IndexedMesh heightfield = TestMeshes::make_heightfield(64u);
+
+		Test::run("LOD chain errors within targets (sphere)", [&]() { check_chain_errors(sphere); });
+		Test::run("LOD chain errors within targets (heightfield)", [&]() { check_chain_errors(heightfield); });
+		Test::run("LOD chain triangle ratio (sphere)", [&]() { check_chain_ratio(sphere); });
+		Test::run("LOD chain triangle ratio (heightfield)", [&]() { check_chain_ratio(heightfield); });
+		Test::run("LOD chain without optimization keeps source order", [&]() { check_chain_unoptimized(sphere); });
+		Test::run("Simplify to triangle and error targets (sphere)", [&]() { check_simplify(sphere); });
+		Test::run("Simplify to triangle and error targets (heightfield)", [&]() { check_simplify(heightfield); });
+		Test::run("LOD selection coarsens with distance", check_selector);
+	}
+
+} // namespace coral
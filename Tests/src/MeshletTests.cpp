@@ -0,0 +1,142 @@
+#include "Test.h"
+#include "TestMeshes.h"
+
+#include "FrustumCuller.h"
+#include "MeshletBuilder.h"
+#include "MeshSimplifier.h"
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace coral {
+
+	using Triangle = std::array<MeshPool::Index, 3>;
+
+	static std::vector<Triangle> get_triangles(const IndexedMesh& mesh, std::uint32_t first_index, std::uint32_t index_count)
+	{
+		std::vector<Triangle> triangles;
+		for (std::uint32_t i = first_index; i + 2u < first_index + index_count; i += 3u) {
+			triangles.push_back(Triangle{ mesh.indices[i], mesh.indices[i + 1u], mesh.indices[i + 2u] });
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	/// Meshlets tile each level in order, within the limits, and each level keeps the same triangles, each
+	/// with its winding.
+	static void check_partition(const IndexedMesh& source, const std::vector<LodLevel>& levels)
+	{
+		IndexedMesh mesh = source;
+		std::vector<Meshlet> meshlets = MeshletBuilder::build(mesh, levels);
+
+		std::size_t next = 0u;
+		for (std::size_t lod = 0u; lod < levels.size(); ++lod) {
+			const LodLevel& level = levels[lod];
+			TEST_CHECK(get_triangles(mesh, level.first_index, level.index_count) == get_triangles(source, level.first_index, level.index_count));
+
+			std::uint32_t covered = level.first_index;
+			for (; next < meshlets.size() && meshlets[next].lod == lod; ++next) {
+				const Meshlet& meshlet = meshlets[next];
+				TEST_CHECK(meshlet.first_index == covered);
+				TEST_CHECK(meshlet.index_count % 3u == 0u && meshlet.index_count > 0u);
+				TEST_CHECK(meshlet.index_count / 3u <= MeshletBuilder::MAX_TRIANGLES);
+				TEST_CHECK(meshlet.vertex_count <= MeshletBuilder::MAX_VERTICES);
+
+				std::vector<MeshPool::Index> vertices(mesh.indices.begin() + meshlet.first_index, mesh.indices.begin() + meshlet.first_index + meshlet.index_count);
+				std::sort(vertices.begin(), vertices.end());
+				vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+				TEST_CHECK(meshlet.vertex_count == vertices.size());
+				covered += meshlet.index_count;
+			}
+			TEST_CHECK(covered == level.first_index + level.index_count);
+		}
+		TEST_CHECK(next == meshlets.size());
+	}
+
+	static void check_bounds(const IndexedMesh& source)
+	{
+		IndexedMesh mesh = source;
+		std::vector<Meshlet> meshlets = MeshletBuilder::build(mesh);
+
+		// Every vertex lies in its meshlet's sphere, allowing for rounding
+		std::size_t outside = 0u;
+		for (const Meshlet& meshlet : meshlets) {
+			for (std::uint32_t i = meshlet.first_index; i < meshlet.first_index + meshlet.index_count; ++i) {
+				outside += glm::distance(mesh.vertices[mesh.indices[i]].position, meshlet.center) > meshlet.radius * 1.0001f + 1e-6f;
+			}
+		}
+		TEST_CHECK(outside == 0u);
+
+		// A meshlet culled by its cone has no triangle facing the camera, from anywhere in or around the mesh
+		std::mt19937 random(3u);
+		std::uniform_real_distribution<float> coordinate(-3.0f, 3.0f);
+		std::size_t culled = 0u;
+		std::size_t unsafe = 0u;
+		for (int camera_index = 0; camera_index < 200; ++camera_index) {
+			glm::vec3 camera{ coordinate(random), coordinate(random), coordinate(random) };
+			glm::vec3 direction = glm::normalize(glm::vec3{ coordinate(random), coordinate(random), coordinate(random) });
+			for (const Meshlet& meshlet : meshlets) {
+				bool backfacing = meshlet.is_backfacing(camera);
+				bool backfacing_along = meshlet.is_backfacing_along(direction);
+				culled += backfacing + backfacing_along;
+				if (!backfacing && !backfacing_along) {
+					continue;
+				}
+				for (std::uint32_t i = meshlet.first_index; i < meshlet.first_index + meshlet.index_count; i += 3u) {
+					const glm::vec3& p0 = mesh.vertices[mesh.indices[i]].position;
+					glm::vec3 normal = glm::cross(mesh.vertices[mesh.indices[i + 1u]].position - p0, mesh.vertices[mesh.indices[i + 2u]].position - p0);
+					float length = glm::length(normal);
+					if (length == 0.0f) {
+						continue;
+					}
+					normal /= length;
+					unsafe += backfacing && glm::dot(normal, camera - p0) > 1e-5f;
+					unsafe += backfacing_along && glm::dot(normal, direction) < -1e-5f;
+				}
+			}
+		}
+		TEST_CHECK(unsafe == 0u);
+		TEST_CHECK(culled > 0u);
+	}
+
+	static void check_frustum_spheres()
+	{
+		// Planes at one unit from the origin along each axis
+		Frustum box = Frustum::from_matrix(glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f));
+		TEST_CHECK(box.intersects_sphere(glm::vec3{ 0.0f }, 0.1f));
+		TEST_CHECK(box.intersects_sphere(glm::vec3{ 1.5f, 0.0f, 0.0f }, 0.6f));
+		TEST_CHECK(!box.intersects_sphere(glm::vec3{ 1.5f, 0.0f, 0.0f }, 0.4f));
+		TEST_CHECK(!box.intersects_sphere(glm::vec3{ 0.0f, -1.5f, 0.0f }, 0.4f));
+		TEST_CHECK(!box.intersects_sphere(glm::vec3{ 0.0f, 0.0f, 1.5f }, 0.4f));
+
+		// Perspective camera at the origin looking down -z
+		Frustum view = Frustum::from_matrix(glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f));
+		TEST_CHECK(view.intersects_sphere(glm::vec3{ 0.0f, 0.0f, -10.0f }, 1.0f));
+		TEST_CHECK(!view.intersects_sphere(glm::vec3{ 0.0f, 0.0f, 10.0f }, 1.0f));
+		TEST_CHECK(!view.intersects_sphere(glm::vec3{ 0.0f, 0.0f, -110.0f }, 1.0f));
+		// Just past the right plane, x = -z, by less and by more than the radius
+		TEST_CHECK(view.intersects_sphere(glm::vec3{ 10.5f, 0.0f, -10.0f }, 1.0f));
+		TEST_CHECK(!view.intersects_sphere(glm::vec3{ 12.0f, 0.0f, -10.0f }, 1.0f));
+	}
+
+	void run_meshlet_tests()
+	{
+		IndexedMesh sphere = TestMeshes::make_sphere(4u, 0.01f);
+		IndexedMesh heightfield = TestMeshes::make_heightfield(64u);
+		LodChain chain = MeshSimplifier::build_lod_chain(sphere, LodSettings{});
+
+		Test::run("Meshlets partition the mesh within limits (sphere)", [&]() { check_partition(sphere, { LodLevel{ 0u, static_cast<std::uint32_t>(sphere.indices.size()), 0.0f } }); });
+		Test::run("Meshlets partition the mesh within limits (heightfield)", [&]() { check_partition(heightfield, { LodLevel{ 0u, static_cast<std::uint32_t>(heightfield.indices.size()), 0.0f } }); });
+		Test::run("Meshlets partition each level of detail", [&]() { check_partition(chain.mesh, chain.levels); });
+		Test::run("Meshlet spheres and cones bound their triangles (sphere)", [&]() { check_bounds(sphere); });
+		Test::run("Meshlet spheres and cones bound their triangles (heightfield)", [&]() { check_bounds(heightfield); });
+		Test::run("Frustum sphere test", check_frustum_spheres);
+	}
+
+} // namespace coral
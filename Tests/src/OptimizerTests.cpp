@@ -0,0 +1,131 @@
+#include "Test.h"
+#include "TestMeshes.h"
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace coral {
+
+	using Triangle = std::array<MeshPool::Index, 3>;
+
+	/// Triangles of a list, each rotated to start at its lowest index so the same triangle compares equal
+	/// whichever vertex it starts from, sorted.
+	static std::vector<Triangle> get_sorted_triangles(const std::vector<MeshPool::Index>& indices)
+	{
+		std::vector<Triangle> triangles;
+		for (std::size_t i = 0u; i + 2u < indices.size(); i += 3u) {
+			Triangle triangle{ indices[i], indices[i + 1u], indices[i + 2u] };
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles.push_back(triangle);
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	/// The same mesh with its triangles in random order, the worst case for the cache.
+	static IndexedMesh shuffle_triangles(IndexedMesh mesh)
+	{
+		std::vector<Triangle> triangles;
+		for (std::size_t i = 0u; i < mesh.indices.size(); i += 3u) {
+			triangles.push_back(Triangle{ mesh.indices[i], mesh.indices[i + 1u], mesh.indices[i + 2u] });
+		}
+		std::shuffle(triangles.begin(), triangles.end(), std::mt19937(5u));
+		mesh.indices.clear();
+		for (const Triangle& triangle : triangles) {
+			mesh.indices.insert(mesh.indices.end(), triangle.begin(), triangle.end());
+		}
+		return mesh;
+	}
+
+	/// Triangles keep their winding and only move, and the cache does no worse than before.
+	static void check_reorder(const IndexedMesh& mesh, float max_acmr)
+	{
+		MeshOptimizer::CacheStats before = MeshOptimizer::analyze_vertex_cache(mesh.indices, mesh.vertices.size());
+
+		std::vector<std::uint32_t> cluster_starts;
+		std::vector<MeshPool::Index> cache_order = MeshOptimizer::optimize_vertex_cache(mesh.indices, mesh.vertices.size(), &cluster_starts);
+		TEST_CHECK(get_sorted_triangles(cache_order) == get_sorted_triangles(mesh.indices));
+		TEST_CHECK(!cluster_starts.empty() && cluster_starts.front() == 0u);
+		TEST_CHECK(std::is_sorted(cluster_starts.begin(), cluster_starts.end()));
+
+		MeshOptimizer::CacheStats after = MeshOptimizer::analyze_vertex_cache(cache_order, mesh.vertices.size());
+		TEST_CHECK(after.acmr <= before.acmr);
+		TEST_CHECK(after.acmr < max_acmr);
+
+		std::vector<MeshPool::Index> overdraw_order = MeshOptimizer::optimize_overdraw(cache_order, mesh.vertices, cluster_starts);
+		TEST_CHECK(get_sorted_triangles(overdraw_order) == get_sorted_triangles(mesh.indices));
+		TEST_CHECK(MeshOptimizer::analyze_vertex_cache(overdraw_order, mesh.vertices.size()).acmr <= before.acmr);
+
+		IndexedMesh optimized = mesh;
+		MeshOptimizer::Report report = MeshOptimizer::optimize(optimized);
+		TEST_CHECK(report.before.acmr == before.acmr);
+		TEST_CHECK(report.after.acmr <= report.before.acmr);
+	}
+
+	/// The remap from optimize_vertex_fetch leads every new vertex back to the one it came from.
+	static void check_fetch(const IndexedMesh& mesh)
+	{
+		// An unused vertex, which must be dropped
+		IndexedMesh source = mesh;
+		source.vertices.push_back(MeshPool::Vertex{ glm::vec3{ 9.0f } });
+
+		IndexedMesh fetched = source;
+		std::vector<MeshPool::Index> sources = MeshOptimizer::optimize_vertex_fetch(fetched);
+		TEST_CHECK(sources.size() == fetched.vertices.size());
+		TEST_CHECK(fetched.vertices.size() == mesh.vertices.size());
+		TEST_CHECK(fetched.indices.size() == source.indices.size());
+
+		std::size_t moved = 0u;
+		for (std::size_t v = 0u; v < fetched.vertices.size(); ++v) {
+			moved += fetched.vertices[v].position != source.vertices[sources[v]].position;
+		}
+		TEST_CHECK(moved == 0u);
+
+		// Triangles stay in place and refer to the same positions
+		std::size_t changed = 0u;
+		for (std::size_t i = 0u; i < fetched.indices.size(); ++i) {
+			changed += sources[fetched.indices[i]] != source.indices[i];
+		}
+		TEST_CHECK(changed == 0u);
+
+		// Vertices are numbered in order of first use
+		MeshPool::Index next = 0u;
+		bool in_order = true;
+		for (MeshPool::Index index : fetched.indices) {
+			in_order = in_order && index <= next;
+			next = std::max<MeshPool::Index>(next, index + 1u);
+		}
+		TEST_CHECK(in_order);
+	}
+
+	static void check_short_lists()
+	{
+		for (std::size_t count : { 0u, 1u, 2u }) {
+			std::vector<MeshPool::Index> indices(count, 0u);
+			MeshOptimizer::CacheStats stats = MeshOptimizer::analyze_vertex_cache(indices, 1u);
+			TEST_CHECK(stats.acmr == 0.0f && stats.atvr == 0.0f);
+		}
+	}
+
+	void run_optimizer_tests()
+	{
+		IndexedMesh sphere = TestMeshes::make_sphere(4u, 0.0f);
+		IndexedMesh heightfield = TestMeshes::make_heightfield(64u);
+
+		// A grid can reach 0.5; Tipsify with a 16 entry cache gets well under 0.8
+		Test::run("Reorder keeps triangles and lowers ACMR (heightfield)", [&]() { check_reorder(heightfield, 0.8f); });
+		Test::run("Reorder keeps triangles and lowers ACMR (shuffled heightfield)", [&]() { check_reorder(shuffle_triangles(heightfield), 0.8f); });
+		Test::run("Reorder keeps triangles and lowers ACMR (shuffled sphere)", [&]() { check_reorder(shuffle_triangles(sphere), 0.8f); });
+		Test::run("Fetch remap reproduces the original vertices (heightfield)", [&]() { check_fetch(heightfield); });
+		Test::run("Fetch remap reproduces the original vertices (shuffled sphere)", [&]() { check_fetch(shuffle_triangles(sphere)); });
+		Test::run("Cache analysis of fewer than three indices", check_short_lists);
+	}
+
+} // namespace coral
@@ -0,0 +1,73 @@
+#include "Test.h"
+
+#include "Std140.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace coral {
+
+	// Offsets from the std140 rules in the OpenGL 4.5 specification, section 7.6.2.2
+	static_assert(Std140Type<float>::ALIGNMENT == 4 && Std140Type<float>::SIZE == 4);
+	static_assert(Std140Type<glm::vec<1, float>>::ALIGNMENT == 4 && Std140Type<glm::vec<1, float>>::SIZE == 4);
+	static_assert(Std140Type<glm::vec2>::ALIGNMENT == 8 && Std140Type<glm::vec2>::SIZE == 8);
+	static_assert(Std140Type<glm::vec3>::ALIGNMENT == 16 && Std140Type<glm::vec3>::SIZE == 12);
+	static_assert(Std140Type<glm::mat4>::ALIGNMENT == 16 && Std140Type<glm::mat4>::SIZE == 64);
+	static_assert(Std140Type<glm::mat3>::SIZE == 48);
+	static_assert(Std140Type<std::array<float, 3>>::STRIDE == 16 && Std140Type<std::array<float, 3>>::SIZE == 48);
+	static_assert(Std140Type<std::array<glm::vec3, 2>>::STRIDE == 16);
+	static_assert(Std140Type<std::array<glm::mat4, 2>>::STRIDE == 64);
+
+	// A float fills the tail of a vec3
+	using Vec3Float = Std140Layout<glm::vec3, float>;
+	static_assert(Vec3Float::OFFSET<1> == 12 && Vec3Float::SIZE == 16);
+
+	// A vec2 after a float skips to the next multiple of 8, and a vec3 after it to the next multiple of 16
+	using FloatVec2Vec3 = Std140Layout<float, glm::vec2, glm::vec3>;
+	static_assert(FloatVec2Vec3::OFFSET<1> == 8 && FloatVec2Vec3::OFFSET<2> == 16 && FloatVec2Vec3::SIZE == 28);
+
+	// Matrices and arrays start on a multiple of 16, and whatever follows an array starts after its padded last element
+	using FloatMat4 = Std140Layout<float, glm::mat4, float>;
+	static_assert(FloatMat4::OFFSET<1> == 16 && FloatMat4::OFFSET<2> == 80);
+	using FloatArray = Std140Layout<float, std::array<float, 2>, float>;
+	static_assert(FloatArray::OFFSET<1> == 16 && FloatArray::OFFSET<2> == 48 && FloatArray::ALIGNMENT == 16);
+
+	template<typename T>
+	static T read(const std::byte* data, std::size_t offset)
+	{
+		T value;
+		std::memcpy(&value, data + offset, sizeof(T));
+		return value;
+	}
+
+	/// Values land at their offsets, with matrix columns and array elements padded to 16 bytes.
+	static void check_writes()
+	{
+		using Layout = Std140Layout<glm::vec3, float, glm::mat3, std::array<float, 2>, bool>;
+		Layout::Block block;
+		block.set<0>(glm::vec3{ 1.0f, 2.0f, 3.0f });
+		block.set<1>(4.0f);
+		block.set<2>(glm::mat3{ glm::vec3{ 5.0f, 6.0f, 7.0f }, glm::vec3{ 8.0f, 9.0f, 10.0f }, glm::vec3{ 11.0f, 12.0f, 13.0f } });
+		block.set<3>(std::array<float, 2>{ 14.0f, 15.0f });
+		block.set<4>(true);
+
+		const std::byte* data = block.data();
+		TEST_CHECK(read<float>(data, 0u) == 1.0f && read<float>(data, 8u) == 3.0f);
+		TEST_CHECK(read<float>(data, 12u) == 4.0f);
+		TEST_CHECK(Layout::OFFSET<2> == 16u);
+		TEST_CHECK(read<float>(data, 16u) == 5.0f && read<float>(data, 32u) == 8.0f && read<float>(data, 48u) == 11.0f && read<float>(data, 56u) == 13.0f);
+		TEST_CHECK(read<float>(data, 28u) == 0.0f);
+		TEST_CHECK(Layout::OFFSET<3> == 64u);
+		TEST_CHECK(read<float>(data, 64u) == 14.0f && read<float>(data, 80u) == 15.0f);
+		TEST_CHECK(Layout::OFFSET<4> == 96u && read<std::uint32_t>(data, 96u) == 1u);
+		TEST_CHECK(Layout::SIZE == 100u);
+	}
+
+	void run_std140_tests()
+	{
+		Test::run("Std140 writes values at their offsets", check_writes);
+	}
+
+} // namespace coral
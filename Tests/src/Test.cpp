@@ -0,0 +1,43 @@
+#include "Test.h"
+
+#include "Util.h"
+
+#include <exception>
+#include <iostream>
+
+namespace coral {
+
+	void Test::run(const char* name, const std::function<void()>& body)
+	{
+		std::size_t failed_before = failed_checks;
+		try {
+			body();
+		} catch (const std::exception& e) {
+			Util::set_color(AnsiColor::RED);
+			std::cout << "  threw: " << e.what() << '\n';
+			Util::clear_color();
+			++failed_checks;
+		}
+
+		bool passed = failed_checks == failed_before;
+		if (!passed) {
+			++failed_tests;
+		}
+
+		Util::set_color(passed ? AnsiColor::GREEN : AnsiColor::RED);
+		std::cout << (passed ? "PASS " : "FAIL ") << name << '\n';
+		Util::clear_color();
+	}
+
+	void Test::check(bool passed, const char* expression, const char* file, int line)
+	{
+		if (!passed) {
+			++failed_checks;
+
+			Util::set_color(AnsiColor::RED);
+			std::cout << "  " << file << ':' << line << ": check failed: " << expression << '\n';
+			Util::clear_color();
+		}
+	}
+
+} // namespace coral
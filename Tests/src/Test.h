@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace coral {
+
+	/// Minimal runner for tests of the engine's CPU-only code, so they need no GL context. A failed check is
+	/// reported with its location and the test carries on, so one run lists every failure.
+	class Test {
+
+		static inline std::size_t failed_checks = 0u;
+		static inline std::size_t failed_tests = 0u;
+
+	public:
+
+		/// Run a test, reporting whether all of its checks passed. An escaping exception fails the test.
+		static void run(const char* name, const std::function<void()>& body);
+
+		/// Record the result of a check. Use TEST_CHECK rather than calling this directly.
+		static void check(bool passed, const char* expression, const char* file, int line);
+
+		[[nodiscard]] static std::size_t get_failed_tests() noexcept { return failed_tests; }
+
+	};
+
+	void run_cull_tests();
+	void run_lod_tests();
+	void run_meshlet_tests();
+	void run_optimizer_tests();
+	void run_std140_tests();
+
+} // namespace coral
+
+#define TEST_CHECK(expression) ::coral::Test::check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
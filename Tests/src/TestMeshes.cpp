@@ -0,0 +1,87 @@
+#include "TestMeshes.h"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace coral {
+
+	IndexedMesh TestMeshes::make_sphere(unsigned int subdivisions, float noise)
+	{
+		const float t = (1.0f + std::sqrt(5.0f)) * 0.5f;
+		std::vector<glm::vec3> positions{
+			{ -1.0f, t, 0.0f }, { 1.0f, t, 0.0f }, { -1.0f, -t, 0.0f }, { 1.0f, -t, 0.0f },
+			{ 0.0f, -1.0f, t }, { 0.0f, 1.0f, t }, { 0.0f, -1.0f, -t }, { 0.0f, 1.0f, -t },
+			{ t, 0.0f, -1.0f }, { t, 0.0f, 1.0f }, { -t, 0.0f, -1.0f }, { -t, 0.0f, 1.0f },
+		};
+		std::vector<MeshPool::Index> indices{
+			0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11, 1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8,
+			3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9, 4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1,
+		};
+		for (glm::vec3& position : positions) {
+			position = glm::normalize(position);
+		}
+
+		// Split every triangle in four, sharing the new vertex of each edge between its two triangles
+		for (unsigned int level = 0u; level < subdivisions; ++level) {
+			std::map<std::pair<MeshPool::Index, MeshPool::Index>, MeshPool::Index> midpoints;
+			auto midpoint = [&](MeshPool::Index a, MeshPool::Index b) {
+				auto [it, inserted] = midpoints.try_emplace({ std::min(a, b), std::max(a, b) }, static_cast<MeshPool::Index>(positions.size()));
+				if (inserted) {
+					positions.push_back(glm::normalize(positions[a] + positions[b]));
+				}
+				return it->second;
+			};
+
+			std::vector<MeshPool::Index> split;
+			split.reserve(indices.size() * 4u);
+			for (std::size_t i = 0u; i < indices.size(); i += 3u) {
+				MeshPool::Index a = indices[i], b = indices[i + 1u], c = indices[i + 2u];
+				MeshPool::Index ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+				split.insert(split.end(), { a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca });
+			}
+			indices = std::move(split);
+		}
+
+		std::mt19937 random(7u);
+		std::uniform_real_distribution<float> offset(-noise, noise);
+
+		IndexedMesh mesh;
+		mesh.vertices.reserve(positions.size());
+		for (const glm::vec3& position : positions) {
+			mesh.vertices.push_back(MeshPool::Vertex{ position * (1.0f + offset(random)) });
+		}
+		mesh.indices = std::move(indices);
+		return mesh;
+	}
+
+	IndexedMesh TestMeshes::make_heightfield(unsigned int size)
+	{
+		std::mt19937 random(11u);
+		std::uniform_real_distribution<float> offset(-0.002f, 0.002f);
+
+		IndexedMesh mesh;
+		float step = 1.0f / static_cast<float>(size - 1u);
+		for (unsigned int y = 0u; y < size; ++y) {
+			for (unsigned int x = 0u; x < size; ++x) {
+				float height = 0.05f * std::sin(static_cast<float>(x) * 0.2f) * std::cos(static_cast<float>(y) * 0.15f) + offset(random);
+				mesh.vertices.push_back(MeshPool::Vertex{ glm::vec3{ static_cast<float>(x) * step, static_cast<float>(y) * step, height } });
+			}
+		}
+
+		for (unsigned int y = 0u; y + 1u < size; ++y) {
+			for (unsigned int x = 0u; x + 1u < size; ++x) {
+				MeshPool::Index a = y * size + x;
+				MeshPool::Index b = a + size;
+				mesh.indices.insert(mesh.indices.end(), { a, a + 1u, b, a + 1u, b + 1u, b });
+			}
+		}
+		return mesh;
+	}
+
+} // namespace coral
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "MeshUtil.h"
+
+namespace coral {
+
+	/// Deterministic meshes for tests.
+	class TestMeshes {
+	public:
+
+		/// Closed unit sphere made by subdividing an icosahedron, its radius perturbed by up to noise.
+		[[nodiscard]] static IndexedMesh make_sphere(unsigned int subdivisions, float noise);
+
+		/// Open, gently rolling square surface of size by size vertices spanning [0, 1] in x and y.
+		[[nodiscard]] static IndexedMesh make_heightfield(unsigned int size);
+
+	};
+
+} // namespace coral
@@ -0,0 +1,34 @@
+#include "Test.h"
+
+#include "Util.h"
+
+#include <iostream>
+
+using namespace coral;
+
+int main()
+{
+	Util::print_divider("Mesh Optimizer");
+	run_optimizer_tests();
+	Util::print_divider("Level of Detail");
+	run_lod_tests();
+	Util::print_divider("Meshlets");
+	run_meshlet_tests();
+	Util::print_divider("Frustum Culling");
+	run_cull_tests();
+	Util::print_divider("Std140");
+	run_std140_tests();
+
+	std::size_t failed = Test::get_failed_tests();
+	if (failed > 0u) {
+		Util::set_color(AnsiColor::RED);
+		std::cout << '\n' << failed << " tests failed\n";
+		Util::clear_color();
+		return 1;
+	}
+
+	Util::set_color(AnsiColor::GREEN);
+	std::cout << "\nAll tests passed\n";
+	Util::clear_color();
+	return 0;
+}
@@ -0,0 +1,9 @@
+const float PI = 3.14159;
+const float TWO_PI = PI * 2;
+
+layout (std140, binding = 0) uniform ApplicationBlock {
+    ivec2 window_size;
+    ivec2 mouse_position;
+    float total_time;
+    float corrected_time;
+} Application;
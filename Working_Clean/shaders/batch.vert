@@ -0,0 +1,23 @@
+#version 450 core
+#extension GL_ARB_shader_draw_parameters : require
+
+layout (location = 0) in vec3 position;
+
+struct ObjectData {
+    vec4 transform; // xy offset, zw scale
+    vec4 color;
+};
+
+layout (std430, binding = 1) readonly buffer ObjectBlock {
+    ObjectData objects[];
+};
+
+out vec4 object_color;
+
+void main()
+{
+    // Batched draws pass the object index as their base instance
+    ObjectData object = objects[gl_BaseInstanceARB + gl_InstanceID];
+    object_color = object.color;
+    gl_Position = vec4(position.xy * object.transform.zw + object.transform.xy, position.z, 1.0);
+}
\ No newline at end of file
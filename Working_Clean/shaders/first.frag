@@ -1,14 +1,6 @@
 #version 450 core
 
-const float PI = 3.14159;
-const float TWO_PI = PI * 2;
-
-layout (std140, binding = 0) uniform ApplicationBlock {
-    ivec2 window_size;
-    ivec2 mouse_position;
-    float total_time;
-    float corrected_time;
-} Application;
+#include "application.glsl"
 
 out vec4 OutColor;
 
@@ -25,9 +17,15 @@ void main()
 
     color = mix(vec3(0.05), color, factor);
 
+#ifndef HIDE_CURSOR
     if (distance(gl_FragCoord.xy, Application.mouse_position) < 20) {
         color = vec3(1.0);
     }
+#endif
+
+#ifdef GRAYSCALE
+    color = vec3(dot(color, vec3(0.2126, 0.7152, 0.0722)));
+#endif
 
     OutColor = vec4(color, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,16 @@
+#version 450 core
+
+in vec3 packed_normal;
+in vec2 packed_uv;
+in vec4 packed_color;
+
+out vec4 OutColor;
+
+void main()
+{
+    const vec3 LIGHT = normalize(vec3(0.4, 0.6, 0.7));
+
+    float diffuse = max(dot(normalize(packed_normal), LIGHT), 0.0) * 0.8 + 0.2;
+    float stripe = step(0.5, fract(packed_uv.x * 8.0)) * 0.25 + 0.75;
+    OutColor = vec4(packed_color.rgb * diffuse * stripe, packed_color.a);
+}
\ No newline at end of file
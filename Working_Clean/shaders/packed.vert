@@ -0,0 +1,42 @@
+#version 450 core
+
+#include "application.glsl"
+
+// Compressed vertex, see PackedVertex
+layout (location = 0) in vec3 position; // snorm16, dequantized below
+layout (location = 7) in vec2 normal_octahedral;
+layout (location = 8) in vec2 uv;
+layout (location = 9) in vec4 color;
+
+// Constant per mesh, set by MeshPool
+layout (location = 10) in vec3 position_scale;
+layout (location = 11) in vec3 position_offset;
+
+// Size of the sphere, animated so that its level of detail changes
+layout (location = 0) uniform float object_scale;
+
+out vec3 packed_normal;
+out vec2 packed_uv;
+out vec4 packed_color;
+
+vec3 decode_octahedral(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+void main()
+{
+    float angle = Application.corrected_time * 0.5;
+    mat3 spin = mat3(cos(angle), 0.0, -sin(angle), 0.0, 1.0, 0.0, sin(angle), 0.0, cos(angle));
+
+    vec3 world = spin * (position * position_scale + position_offset) * object_scale;
+    float aspect = float(Application.window_size.y) / float(Application.window_size.x);
+
+    packed_normal = spin * decode_octahedral(normal_octahedral);
+    packed_uv = uv;
+    packed_color = color;
+    gl_Position = vec4(world.x * aspect, world.y, -world.z * 0.5 + 0.5, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 450 core
+
+in vec4 sprite_color;
+
+out vec4 OutColor;
+
+void main()
+{
+    OutColor = sprite_color;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#version 450 core
+
+layout (location = 0) in vec3 position;
+
+// Per-instance stream, advanced once per instance
+layout (location = 1) in mat4 instance_transform; // locations 1-4, one per column
+layout (location = 5) in vec4 instance_color;
+layout (location = 6) in vec4 instance_custom;
+
+out vec4 sprite_color;
+
+void main()
+{
+    sprite_color = instance_color;
+    gl_Position = instance_transform * vec4(position, 1.0);
+}
\ No newline at end of file
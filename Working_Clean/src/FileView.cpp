@@ -0,0 +1,167 @@
+#include "FileView.h"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace coral {
+
+	static void throw_open_failure(const std::string& filename)
+	{
+		static const std::string msg = "Failed to open file: ";
+		throw std::runtime_error(msg + filename);
+	}
+
+#ifdef _WIN32
+
+	FileView::FileView(const std::string& filename, FileAccess access)
+	{
+		DWORD flags = (access == FileAccess::SEQUENTIAL) ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL;
+		HANDLE handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, flags, nullptr);
+		if (handle == INVALID_HANDLE_VALUE) {
+			throw_open_failure(filename);
+		}
+		file = handle;
+
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(handle, &file_size)) {
+			release();
+			throw_open_failure(filename);
+		}
+		size = static_cast<std::size_t>(file_size.QuadPart);
+
+		// Zero length files cannot be mapped, but are valid empty views
+		if (size == 0u) {
+			return;
+		}
+
+		mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr) {
+			release();
+			throw_open_failure(filename);
+		}
+
+		data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		if (data == nullptr) {
+			release();
+			throw_open_failure(filename);
+		}
+
+		if (access == FileAccess::WILL_NEED) {
+			WIN32_MEMORY_RANGE_ENTRY range{ const_cast<char*>(data), size };
+			PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+		}
+	}
+
+	void FileView::release() noexcept
+	{
+		if (data != nullptr) {
+			UnmapViewOfFile(data);
+		}
+		if (mapping != nullptr) {
+			CloseHandle(mapping);
+		}
+		if (file != nullptr) {
+			CloseHandle(file);
+		}
+		data = nullptr;
+		mapping = nullptr;
+		file = nullptr;
+		size = 0u;
+	}
+
+	FileView::FileView(FileView&& other) noexcept
+		: data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0u)),
+		file(std::exchange(other.file, nullptr)), mapping(std::exchange(other.mapping, nullptr))
+	{
+	}
+
+	FileView& FileView::operator=(FileView&& other) noexcept
+	{
+		if (this != &other) {
+			release();
+			data = std::exchange(other.data, nullptr);
+			size = std::exchange(other.size, 0u);
+			file = std::exchange(other.file, nullptr);
+			mapping = std::exchange(other.mapping, nullptr);
+		}
+		return *this;
+	}
+
+#else
+
+	FileView::FileView(const std::string& filename, FileAccess access)
+	{
+		int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0) {
+			throw_open_failure(filename);
+		}
+
+		struct stat info;
+		if (fstat(fd, &info) != 0) {
+			close(fd);
+			throw_open_failure(filename);
+		}
+		size = static_cast<std::size_t>(info.st_size);
+
+		// Zero length files cannot be mapped, but are valid empty views
+		if (size > 0u) {
+			void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapped == MAP_FAILED) {
+				close(fd);
+				throw_open_failure(filename);
+			}
+			data = static_cast<const char*>(mapped);
+
+			if (access == FileAccess::SEQUENTIAL) {
+				madvise(mapped, size, MADV_SEQUENTIAL);
+			} else if (access == FileAccess::WILL_NEED) {
+				madvise(mapped, size, MADV_WILLNEED);
+			}
+		}
+
+		// The mapping keeps the file alive
+		close(fd);
+	}
+
+	void FileView::release() noexcept
+	{
+		if (data != nullptr) {
+			munmap(const_cast<char*>(data), size);
+		}
+		data = nullptr;
+		size = 0u;
+	}
+
+	FileView::FileView(FileView&& other) noexcept
+		: data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0u))
+	{
+	}
+
+	FileView& FileView::operator=(FileView&& other) noexcept
+	{
+		if (this != &other) {
+			release();
+			data = std::exchange(other.data, nullptr);
+			size = std::exchange(other.size, 0u);
+		}
+		return *this;
+	}
+
+#endif
+
+	FileView::~FileView()
+	{
+		release();
+	}
+
+} // namespace coral
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace coral {
+
+	/// How a mapped file is going to be read, passed on to the OS as a paging hint.
+	enum class FileAccess {
+		NORMAL,
+		SEQUENTIAL,
+		/// Start reading the whole file in ahead of use.
+		WILL_NEED,
+	};
+
+	/// Read-only memory mapped view of an entire file. Gives direct access to the page cache without
+	/// copying the contents into a heap allocation. The view stays valid for the lifetime of the object.
+	class FileView {
+
+		const char* data = nullptr;
+		std::size_t size = 0u;
+
+#ifdef _WIN32
+		void* file = nullptr;
+		void* mapping = nullptr;
+#endif
+
+	public:
+
+		explicit FileView(const std::string& filename, FileAccess access = FileAccess::NORMAL);
+		~FileView();
+
+		FileView(const FileView&) = delete;
+		FileView& operator=(const FileView&) = delete;
+
+		FileView(FileView&& other) noexcept;
+		FileView& operator=(FileView&& other) noexcept;
+
+		[[nodiscard]] std::string_view get_view() const noexcept { return std::string_view(data, size); }
+
+		[[nodiscard]] const char* get_data() const noexcept { return data; }
+
+		[[nodiscard]] std::size_t get_size() const noexcept { return size; }
+
+	private:
+
+		void release() noexcept;
+
+	};
+
+} // namespace coral
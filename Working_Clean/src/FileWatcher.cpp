@@ -0,0 +1,141 @@
+#include "FileWatcher.h"
+
+#include "Util.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace coral {
+
+	FileWatcher::FileWatcher(const std::string& directory)
+		: directory(directory)
+	{
+		worker = std::thread(&FileWatcher::run, this);
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		running = false;
+		worker.join();
+	}
+
+	std::vector<FileWatcher::Change> FileWatcher::take_changes()
+	{
+		std::vector<Change> taken;
+		std::lock_guard<std::mutex> lock(mutex);
+		taken.swap(changes);
+		return taken;
+	}
+
+	void FileWatcher::mark_dirty(const std::string& name)
+	{
+		dirty[name] = Clock::now();
+	}
+
+	void FileWatcher::flush_settled()
+	{
+		Clock::time_point now = Clock::now();
+
+		for (auto it = dirty.begin(); it != dirty.end();) {
+			if (now - it->second < DEBOUNCE) {
+				++it;
+				continue;
+			}
+
+			try {
+				Change change{ it->first, Util::read_file((std::filesystem::path(directory) / it->first).string()) };
+				std::lock_guard<std::mutex> lock(mutex);
+				changes.push_back(std::move(change));
+			} catch (const std::exception&) {
+				// Deleted or still locked by the editor. A later event will pick it up again.
+			}
+			it = dirty.erase(it);
+		}
+	}
+
+#ifdef _WIN32
+
+	void FileWatcher::run()
+	{
+		HANDLE handle = FindFirstChangeNotificationA(directory.c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+		if (handle == INVALID_HANDLE_VALUE) {
+			std::cerr << "Failed to watch directory: " << directory << '\n';
+			return;
+		}
+
+		// Change notifications do not say which file changed, so compare write times
+		std::unordered_map<std::string, std::filesystem::file_time_type> write_times;
+		auto scan = [&](bool report) {
+			std::error_code error;
+			for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+				if (!entry.is_regular_file(error)) {
+					continue;
+				}
+				std::string name = entry.path().filename().string();
+				auto time = entry.last_write_time(error);
+				auto [it, inserted] = write_times.try_emplace(name, time);
+				if (report && (inserted || it->second != time)) {
+					it->second = time;
+					mark_dirty(name);
+				}
+			}
+		};
+		scan(false);
+
+		while (running) {
+			if (WaitForSingleObject(handle, static_cast<DWORD>(POLL_INTERVAL.count())) == WAIT_OBJECT_0) {
+				scan(true);
+				FindNextChangeNotification(handle);
+			}
+			flush_settled();
+		}
+
+		FindCloseChangeNotification(handle);
+	}
+
+#else
+
+	void FileWatcher::run()
+	{
+		int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (fd < 0 || inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+			std::cerr << "Failed to watch directory: " << directory << '\n';
+			if (fd >= 0) {
+				close(fd);
+			}
+			return;
+		}
+
+		alignas(inotify_event) char buffer[4096];
+
+		while (running) {
+			pollfd pfd{ fd, POLLIN, 0 };
+			if (poll(&pfd, 1, static_cast<int>(POLL_INTERVAL.count())) > 0) {
+				ssize_t length;
+				while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+					for (char* ptr = buffer; ptr < buffer + length;) {
+						const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+						if (event->len > 0 && !(event->mask & IN_ISDIR)) {
+							mark_dirty(event->name);
+						}
+						ptr += sizeof(inotify_event) + event->len;
+					}
+				}
+			}
+			flush_settled();
+		}
+
+		close(fd);
+	}
+
+#endif
+
+} // namespace coral
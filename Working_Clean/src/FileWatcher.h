@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace coral {
+
+	/// Watches the files of a single directory on a background thread.
+	/// Uses inotify on Linux and change notifications on Windows. Bursts of events for the same file are
+	/// debounced, then the file is read on the worker thread so the main thread only receives finished contents.
+	class FileWatcher {
+	public:
+
+		struct Change {
+			/// File name relative to the watched directory.
+			std::string name;
+			std::string contents;
+		};
+
+	private:
+
+		using Clock = std::chrono::steady_clock;
+
+		static constexpr std::chrono::milliseconds DEBOUNCE{ 100 };
+		static constexpr std::chrono::milliseconds POLL_INTERVAL{ 25 };
+
+		std::string directory;
+
+		std::mutex mutex{};
+		std::vector<Change> changes{};
+
+		std::atomic<bool> running{ true };
+		std::thread worker{};
+
+		/// Worker state: files that changed and when they were last touched.
+		std::unordered_map<std::string, Clock::time_point> dirty{};
+
+	public:
+
+		explicit FileWatcher(const std::string& directory);
+		~FileWatcher();
+
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+
+		/// Take all changes collected since the last call. Never blocks on file system access.
+		[[nodiscard]] std::vector<Change> take_changes();
+
+	private:
+
+		void run();
+
+		void mark_dirty(const std::string& name);
+
+		/// Read files that have been quiet for the debounce period and publish them.
+		void flush_settled();
+
+	};
+
+} // namespace coral
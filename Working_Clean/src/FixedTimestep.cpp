@@ -0,0 +1,30 @@
+#include "FixedTimestep.h"
+
+#include <cmath>
+
+namespace coral {
+
+	FixedTimestep::FixedTimestep(unsigned int tick_rate, unsigned int max_steps)
+		: step(1.0f / static_cast<float>(tick_rate)), max_steps(max_steps)
+	{
+	}
+
+	unsigned int FixedTimestep::advance(float delta) noexcept
+	{
+		accumulator += delta;
+
+		unsigned int steps = 0u;
+		while (accumulator >= step && steps < max_steps) {
+			accumulator -= step;
+			++steps;
+		}
+
+		if (steps == max_steps && accumulator >= step) {
+			// Fell too far behind. Keep only the partial step so rendering stays smooth.
+			accumulator = std::fmod(accumulator, step);
+		}
+
+		return steps;
+	}
+
+} // namespace coral
@@ -0,0 +1,31 @@
+#pragma once
+
+namespace coral {
+
+	/// Accumulates real elapsed time and converts it into a whole number of fixed simulation steps.
+	/// The remainder is exposed as an interpolation factor for rendering between the last two states.
+	class FixedTimestep {
+
+		float step;
+		float accumulator = 0.0f;
+		unsigned int max_steps;
+
+	public:
+
+		/// @param tick_rate Simulation steps per second.
+		/// @param max_steps Upper bound on steps run per frame. Time beyond this is dropped so a long stall
+		///                  cannot snowball into ever longer frames.
+		explicit FixedTimestep(unsigned int tick_rate, unsigned int max_steps = 8u);
+
+		/// Add elapsed real time in seconds. Returns the number of fixed steps to simulate this frame.
+		[[nodiscard]] unsigned int advance(float delta) noexcept;
+
+		/// Duration of a single step in seconds.
+		[[nodiscard]] float get_step() const noexcept { return step; }
+
+		/// Fraction of a step left in the accumulator, in [0, 1). Blend factor from the previous state to the current one.
+		[[nodiscard]] float get_alpha() const noexcept { return accumulator / step; }
+
+	};
+
+} // namespace coral
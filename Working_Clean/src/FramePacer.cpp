@@ -0,0 +1,68 @@
+#include "FramePacer.h"
+
+#include <sdl/SDL_timer.h>
+
+namespace coral {
+
+	FramePacer::FramePacer(unsigned int target_rate)
+		: frequency(SDL_GetPerformanceFrequency())
+	{
+		set_target_rate(target_rate);
+		reset();
+	}
+
+	void FramePacer::set_target_rate(unsigned int rate) noexcept
+	{
+		target_rate = rate;
+		period = (rate == UNCAPPED) ? 0u : frequency / rate;
+		deadline = SDL_GetPerformanceCounter() + period;
+	}
+
+	void FramePacer::reset() noexcept
+	{
+		frame_start = SDL_GetPerformanceCounter();
+		deadline = frame_start + period;
+		last_cost = 0u;
+	}
+
+	float FramePacer::wait() noexcept
+	{
+		std::uint64_t now = SDL_GetPerformanceCounter();
+		last_cost = now - frame_start;
+
+		if (period != 0u) {
+			if (now < deadline) {
+				std::uint64_t remaining_ms = (deadline - now) * 1000u / frequency;
+				if (remaining_ms > SPIN_MARGIN_MS) {
+					SDL_Delay(static_cast<Uint32>(remaining_ms - SPIN_MARGIN_MS));
+				}
+
+				do {
+					now = SDL_GetPerformanceCounter();
+				} while (now < deadline);
+
+				deadline += period;
+			} else {
+				// Missed the deadline. Restart the schedule instead of rushing to catch up.
+				deadline = now + period;
+			}
+		} else {
+			now = SDL_GetPerformanceCounter();
+		}
+
+		float delta = to_seconds(now - frame_start);
+		frame_start = now;
+		return delta;
+	}
+
+	float FramePacer::get_last_frame_cost() const noexcept
+	{
+		return to_seconds(last_cost);
+	}
+
+	float FramePacer::to_seconds(std::uint64_t ticks) const noexcept
+	{
+		return static_cast<float>(static_cast<double>(ticks) / static_cast<double>(frequency));
+	}
+
+} // namespace coral
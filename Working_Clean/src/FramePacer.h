@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+namespace coral {
+
+	/// Paces the main loop to a target frame rate using the high resolution performance counter.
+	/// Sleeps coarsely for most of the remaining frame budget, then spins to the exact deadline.
+	class FramePacer {
+	public:
+
+		/// Target rate which disables pacing entirely.
+		static constexpr unsigned int UNCAPPED = 0u;
+
+	private:
+
+		/// Time left before the deadline that is spun instead of slept, in milliseconds.
+		/// Covers the scheduler granularity of SDL_Delay.
+		static constexpr unsigned int SPIN_MARGIN_MS = 2u;
+
+		std::uint64_t frequency;
+		std::uint64_t period = 0u;
+		std::uint64_t deadline = 0u;
+		std::uint64_t frame_start = 0u;
+		std::uint64_t last_cost = 0u;
+
+		unsigned int target_rate = UNCAPPED;
+
+	public:
+
+		explicit FramePacer(unsigned int target_rate);
+
+		void set_target_rate(unsigned int rate) noexcept;
+
+		/// Restart timing from now. Call before entering the loop so startup time is not counted as a frame.
+		void reset() noexcept;
+
+		[[nodiscard]] unsigned int get_target_rate() const noexcept { return target_rate; }
+
+		/// Block until the next frame deadline. Returns the measured time since the previous call in seconds.
+		float wait() noexcept;
+
+		/// Time spent between the end of the previous wait and the start of this one, in seconds.
+		[[nodiscard]] float get_last_frame_cost() const noexcept;
+
+	private:
+
+		[[nodiscard]] float to_seconds(std::uint64_t ticks) const noexcept;
+
+	};
+
+} // namespace coral
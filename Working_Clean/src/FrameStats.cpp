@@ -0,0 +1,134 @@
+#include "FrameStats.h"
+
+#include "Util.h"
+
+#include <sdl/SDL_timer.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+namespace coral {
+
+	FrameStats::FrameStats()
+		: frequency(SDL_GetPerformanceFrequency())
+	{
+	}
+
+	void FrameStats::begin_frame() noexcept
+	{
+		current.fill(0.0f);
+		last_mark = SDL_GetPerformanceCounter();
+	}
+
+	void FrameStats::mark(FramePhase phase) noexcept
+	{
+		std::uint64_t now = SDL_GetPerformanceCounter();
+		current[static_cast<std::size_t>(phase)] += static_cast<float>(static_cast<double>(now - last_mark) * 1000.0 / static_cast<double>(frequency));
+		last_mark = now;
+	}
+
+	void FrameStats::end_frame()
+	{
+		history.push(current);
+
+		if (csv.is_open()) {
+			csv << history.get_count();
+			for (float duration : current) {
+				csv << ',' << duration;
+			}
+			csv << ',' << std::accumulate(current.begin(), current.end(), 0.0f) << '\n';
+		}
+	}
+
+	FrameStats::Summary FrameStats::summarize(FramePhase phase, std::size_t window) const
+	{
+		std::size_t count = std::min(window, history.get_size());
+		if (count == 0) {
+			return Summary{};
+		}
+
+		std::vector<float> values(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			const Sample& sample = history.recent(i);
+			values[i] = (phase == FramePhase::COUNT)
+				? std::accumulate(sample.begin(), sample.end(), 0.0f)
+				: sample[static_cast<std::size_t>(phase)];
+		}
+
+		auto percentile = [&](float p) {
+			auto nth = values.begin() + static_cast<std::ptrdiff_t>(p * static_cast<float>(count - 1) + 0.5f);
+			std::nth_element(values.begin(), nth, values.end());
+			return *nth;
+		};
+
+		Summary summary;
+		summary.p50 = percentile(0.50f);
+		summary.p95 = percentile(0.95f);
+		summary.p99 = percentile(0.99f);
+		summary.max = *std::max_element(values.begin(), values.end());
+		return summary;
+	}
+
+	void FrameStats::print(std::size_t window) const
+	{
+		Util::print_divider("Frame Stats Begin");
+
+		std::cout << "Frames sampled: " << std::min(window, history.get_size()) << " (milliseconds)\n\n";
+		std::cout << std::left << std::setw(10) << "Phase" << std::right
+			<< std::setw(9) << "p50" << std::setw(9) << "p95" << std::setw(9) << "p99" << std::setw(9) << "max" << '\n';
+
+		std::cout << std::fixed << std::setprecision(3);
+		for (std::size_t i = 0; i <= PHASE_COUNT; ++i) {
+			FramePhase phase = static_cast<FramePhase>(i);
+			Summary summary = summarize(phase, window);
+			std::cout << std::left << std::setw(10) << get_phase_name(phase) << std::right
+				<< std::setw(9) << summary.p50 << std::setw(9) << summary.p95
+				<< std::setw(9) << summary.p99 << std::setw(9) << summary.max << '\n';
+		}
+		std::cout << std::defaultfloat;
+
+		Util::print_divider("Frame Stats End");
+	}
+
+	void FrameStats::open_csv(const std::string& filename)
+	{
+		csv.open(filename, std::ios::out | std::ios::trunc);
+		if (!csv.is_open()) {
+			Util::throw_exception("Failed to open frame stats file", filename.c_str());
+		}
+
+		csv << "frame";
+		for (std::size_t i = 0; i < PHASE_COUNT; ++i) {
+			csv << ',' << get_phase_name(static_cast<FramePhase>(i)) << "_ms";
+		}
+		csv << ",total_ms\n";
+	}
+
+	void FrameStats::close_csv()
+	{
+		csv.close();
+	}
+
+	const char* FrameStats::get_phase_name(FramePhase phase) noexcept
+	{
+		switch (phase) {
+			case FramePhase::EVENTS:
+				return "events";
+			case FramePhase::SIMULATE:
+				return "simulate";
+			case FramePhase::UPDATE:
+				return "update";
+			case FramePhase::DRAW:
+				return "draw";
+			case FramePhase::SWAP:
+				return "swap";
+			case FramePhase::COUNT:
+				return "total";
+		}
+		return "unknown";
+	}
+
+} // namespace coral
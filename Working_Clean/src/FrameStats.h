@@ -0,0 +1,76 @@
+#pragma once
+
+#include "RingBuffer.h"
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+namespace coral {
+
+	enum class FramePhase {
+		EVENTS,
+		SIMULATE,
+		UPDATE,
+		DRAW,
+		SWAP,
+		COUNT,
+	};
+
+	/// Records how long each phase of the main loop takes and summarizes the recent history.
+	class FrameStats {
+	public:
+
+		static constexpr std::size_t PHASE_COUNT = static_cast<std::size_t>(FramePhase::COUNT);
+		static constexpr std::size_t HISTORY = 1024u;
+
+		/// Phase durations of a single frame in milliseconds.
+		using Sample = std::array<float, PHASE_COUNT>;
+
+		struct Summary {
+			float p50 = 0.0f;
+			float p95 = 0.0f;
+			float p99 = 0.0f;
+			float max = 0.0f;
+		};
+
+	private:
+
+		RingBuffer<Sample, HISTORY> history{};
+		Sample current{};
+
+		std::uint64_t frequency;
+		std::uint64_t last_mark = 0u;
+
+		std::ofstream csv{};
+
+	public:
+
+		FrameStats();
+
+		/// Start timing a new frame.
+		void begin_frame() noexcept;
+
+		/// Attribute the time since the previous mark to the given phase.
+		void mark(FramePhase phase) noexcept;
+
+		/// Commit the current frame to the history and the CSV stream, if open.
+		void end_frame();
+
+		/// Percentiles of a phase over the most recent frames. Pass FramePhase::COUNT for the whole frame.
+		[[nodiscard]] Summary summarize(FramePhase phase, std::size_t window = HISTORY - 1) const;
+
+		void print(std::size_t window = HISTORY - 1) const;
+
+		void open_csv(const std::string& filename);
+
+		void close_csv();
+
+		[[nodiscard]] bool is_recording() const noexcept { return csv.is_open(); }
+
+		[[nodiscard]] static const char* get_phase_name(FramePhase phase) noexcept;
+
+	};
+
+} // namespace coral
@@ -0,0 +1,56 @@
+#include "Framebuffer.h"
+
+#include "Util.h"
+
+#include <string>
+
+namespace coral {
+
+	Framebuffer::Framebuffer(int width, int height, const char* label)
+		: width(width), height(height)
+	{
+		glGenRenderbuffers(1, &color);
+		glBindRenderbuffer(GL_RENDERBUFFER, color);
+		glObjectLabel(GL_RENDERBUFFER, color, -1, (std::string(label) + ".Color").c_str());
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+		glBindRenderbuffer(GL_RENDERBUFFER, 0u);
+
+		glGenFramebuffers(1, &fbo);
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		glObjectLabel(GL_FRAMEBUFFER, fbo, -1, label);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+
+		GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0u);
+
+		if (status != GL_FRAMEBUFFER_COMPLETE) {
+			glDeleteFramebuffers(1, &fbo);
+			glDeleteRenderbuffers(1, &color);
+			Util::throw_exception("Framebuffer incomplete", label);
+		}
+	}
+
+	Framebuffer::~Framebuffer()
+	{
+		glDeleteFramebuffers(1, &fbo);
+		glDeleteRenderbuffers(1, &color);
+	}
+
+	void Framebuffer::bind() const noexcept
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	}
+
+	std::vector<std::uint8_t> Framebuffer::read_pixels() const
+	{
+		std::vector<std::uint8_t> pixels(static_cast<std::size_t>(width) * height * 4);
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, 0u);
+
+		return pixels;
+	}
+
+} // namespace coral
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glew/glew.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace coral {
+
+	/// Offscreen render target with a single RGBA8 color attachment.
+	class Framebuffer {
+
+		GLuint fbo = 0u;
+		GLuint color = 0u;
+		int width;
+		int height;
+
+	public:
+
+		Framebuffer(int width, int height, const char* label);
+		~Framebuffer();
+
+		Framebuffer(const Framebuffer&) = delete;
+		Framebuffer& operator=(const Framebuffer&) = delete;
+
+		void bind() const noexcept;
+
+		/// Read back the color attachment as bottom-up RGBA8 rows.
+		[[nodiscard]] std::vector<std::uint8_t> read_pixels() const;
+
+		[[nodiscard]] int get_width() const noexcept { return width; }
+		[[nodiscard]] int get_height() const noexcept { return height; }
+
+	};
+
+} // namespace coral
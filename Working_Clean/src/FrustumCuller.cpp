@@ -0,0 +1,339 @@
+#include "FrustumCuller.h"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CULL_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC compiles any intrinsic anywhere; GCC and Clang need each kernel marked with the instructions it uses
+#if defined(__GNUC__)
+#define CULL_TARGET(features) __attribute__((target(features)))
+#else
+#define CULL_TARGET(features)
+#endif
+
+namespace coral {
+
+	Frustum Frustum::from_matrix(const glm::mat4& matrix) noexcept
+	{
+		// Gribb and Hartmann: each plane is the last row of the matrix plus or minus one of the others
+		auto row = [&](int i) { return glm::vec4{ matrix[0][i], matrix[1][i], matrix[2][i], matrix[3][i] }; };
+		Frustum frustum{ {
+			row(3) + row(0),
+			row(3) - row(0),
+			row(3) + row(1),
+			row(3) - row(1),
+			row(3) + row(2),
+			row(3) - row(2),
+		} };
+		for (glm::vec4& plane : frustum.planes) {
+			plane /= glm::length(glm::vec3{ plane });
+		}
+		return frustum;
+	}
+
+	/// Planes split into components, with the absolute normals used to project box extents.
+	struct CullPlanes {
+		float x[6];
+		float y[6];
+		float z[6];
+		float w[6];
+		float abs_x[6];
+		float abs_y[6];
+		float abs_z[6];
+
+		explicit CullPlanes(const Frustum& frustum) noexcept
+		{
+			for (std::size_t p = 0u; p < 6u; ++p) {
+				const glm::vec4& plane = frustum.planes[p];
+				x[p] = plane.x;
+				y[p] = plane.y;
+				z[p] = plane.z;
+				w[p] = plane.w;
+				abs_x[p] = std::abs(plane.x);
+				abs_y[p] = std::abs(plane.y);
+				abs_z[p] = std::abs(plane.z);
+			}
+		}
+	};
+
+	struct CullArrays {
+		const float* center_x;
+		const float* center_y;
+		const float* center_z;
+		const float* extent_x;
+		const float* extent_y;
+		const float* extent_z;
+		const float* radius;
+	};
+
+	/// Write the index of every set lane of a visibility mask to out. Every lane is written, but only set ones
+	/// advance, so out needs room for all of them.
+	static std::size_t emit_visible(std::uint32_t mask, std::uint32_t first, std::uint32_t lanes, std::uint32_t* out) noexcept
+	{
+		std::size_t written = 0u;
+		for (std::uint32_t lane = 0u; lane < lanes; ++lane) {
+			out[written] = first + lane;
+			written += (mask >> lane) & 1u;
+		}
+		return written;
+	}
+
+	static std::size_t cull_scalar(const CullArrays& arrays, std::size_t count, const CullPlanes& planes, std::uint32_t* out) noexcept
+	{
+		std::size_t written = 0u;
+		for (std::size_t i = 0u; i < count; ++i) {
+			// No early out: which plane rejects an object is unpredictable, and mispredictions cost more than the planes
+			std::uint32_t visible = 1u;
+			for (std::size_t p = 0u; p < 6u; ++p) {
+				float distance = arrays.center_x[i] * planes.x[p] + arrays.center_y[i] * planes.y[p] + arrays.center_z[i] * planes.z[p] + planes.w[p];
+				float box = arrays.extent_x[i] * planes.abs_x[p] + arrays.extent_y[i] * planes.abs_y[p] + arrays.extent_z[i] * planes.abs_z[p];
+				visible &= distance + std::min(box, arrays.radius[i]) >= 0.0f ? 1u : 0u;
+			}
+			out[written] = static_cast<std::uint32_t>(i);
+			written += visible;
+		}
+		return written;
+	}
+
+#ifdef CULL_X86
+
+	CULL_TARGET("sse2")
+	static std::size_t cull_sse(const CullArrays& arrays, std::size_t padded_count, const CullPlanes& planes, std::uint32_t* out) noexcept
+	{
+		// SSE has no broadcast from memory, so the planes are splatted once up front
+		__m128 plane_x[6], plane_y[6], plane_z[6], plane_w[6], plane_abs_x[6], plane_abs_y[6], plane_abs_z[6];
+		for (std::size_t p = 0u; p < 6u; ++p) {
+			plane_x[p] = _mm_set1_ps(planes.x[p]);
+			plane_y[p] = _mm_set1_ps(planes.y[p]);
+			plane_z[p] = _mm_set1_ps(planes.z[p]);
+			plane_w[p] = _mm_set1_ps(planes.w[p]);
+			plane_abs_x[p] = _mm_set1_ps(planes.abs_x[p]);
+			plane_abs_y[p] = _mm_set1_ps(planes.abs_y[p]);
+			plane_abs_z[p] = _mm_set1_ps(planes.abs_z[p]);
+		}
+
+		std::size_t written = 0u;
+		for (std::size_t i = 0u; i < padded_count; i += 4u) {
+			__m128 center_x = _mm_loadu_ps(arrays.center_x + i);
+			__m128 center_y = _mm_loadu_ps(arrays.center_y + i);
+			__m128 center_z = _mm_loadu_ps(arrays.center_z + i);
+			__m128 extent_x = _mm_loadu_ps(arrays.extent_x + i);
+			__m128 extent_y = _mm_loadu_ps(arrays.extent_y + i);
+			__m128 extent_z = _mm_loadu_ps(arrays.extent_z + i);
+			__m128 radius = _mm_loadu_ps(arrays.radius + i);
+
+			__m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (std::size_t p = 0u; p < 6u; ++p) {
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(center_x, plane_x[p]), _mm_mul_ps(center_y, plane_y[p])),
+					_mm_add_ps(_mm_mul_ps(center_z, plane_z[p]), plane_w[p]));
+				__m128 box = _mm_add_ps(_mm_add_ps(_mm_mul_ps(extent_x, plane_abs_x[p]), _mm_mul_ps(extent_y, plane_abs_y[p])), _mm_mul_ps(extent_z, plane_abs_z[p]));
+				visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, _mm_min_ps(box, radius)), _mm_setzero_ps()));
+			}
+
+			auto mask = static_cast<std::uint32_t>(_mm_movemask_ps(visible));
+			written += emit_visible(mask, static_cast<std::uint32_t>(i), 4u, out + written);
+		}
+		return written;
+	}
+
+	/// Offsets of the set lanes of each 8-bit mask, four bits apiece, lowest first.
+	struct LaneTable {
+		std::uint32_t lanes[256];
+		std::uint8_t counts[256];
+
+		constexpr LaneTable() noexcept : lanes{}, counts{}
+		{
+			for (std::uint32_t mask = 0u; mask < 256u; ++mask) {
+				std::uint32_t count = 0u;
+				for (std::uint32_t lane = 0u; lane < 8u; ++lane) {
+					if ((mask >> lane) & 1u) {
+						lanes[mask] |= lane << (count * 4u);
+						++count;
+					}
+				}
+				counts[mask] = static_cast<std::uint8_t>(count);
+			}
+		}
+	};
+
+	static constexpr LaneTable LANE_TABLE{};
+
+	CULL_TARGET("avx2,fma")
+	static std::size_t cull_avx2(const CullArrays& arrays, std::size_t padded_count, const CullPlanes& planes, std::uint32_t* out) noexcept
+	{
+		const __m256i nibble_shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+		const __m256i nibble_mask = _mm256_set1_epi32(0xF);
+
+		std::size_t written = 0u;
+		for (std::size_t i = 0u; i < padded_count; i += 8u) {
+			__m256 center_x = _mm256_loadu_ps(arrays.center_x + i);
+			__m256 center_y = _mm256_loadu_ps(arrays.center_y + i);
+			__m256 center_z = _mm256_loadu_ps(arrays.center_z + i);
+			__m256 extent_x = _mm256_loadu_ps(arrays.extent_x + i);
+			__m256 extent_y = _mm256_loadu_ps(arrays.extent_y + i);
+			__m256 extent_z = _mm256_loadu_ps(arrays.extent_z + i);
+			__m256 radius = _mm256_loadu_ps(arrays.radius + i);
+
+			__m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (std::size_t p = 0u; p < 6u; ++p) {
+				__m256 distance = _mm256_fmadd_ps(center_x, _mm256_broadcast_ss(&planes.x[p]),
+					_mm256_fmadd_ps(center_y, _mm256_broadcast_ss(&planes.y[p]), _mm256_fmadd_ps(center_z, _mm256_broadcast_ss(&planes.z[p]), _mm256_broadcast_ss(&planes.w[p]))));
+				__m256 box = _mm256_fmadd_ps(extent_x, _mm256_broadcast_ss(&planes.abs_x[p]),
+					_mm256_fmadd_ps(extent_y, _mm256_broadcast_ss(&planes.abs_y[p]), _mm256_mul_ps(extent_z, _mm256_broadcast_ss(&planes.abs_z[p]))));
+				visible = _mm256_and_ps(visible, _mm256_cmp_ps(_mm256_add_ps(distance, _mm256_min_ps(box, radius)), _mm256_setzero_ps(), _CMP_GE_OQ));
+			}
+
+			// Unpack the visible lanes' offsets from the table and store all eight; only the visible ones are kept
+			auto mask = static_cast<std::uint32_t>(_mm256_movemask_ps(visible));
+			__m256i offsets = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(LANE_TABLE.lanes[mask])), nibble_shifts), nibble_mask);
+			__m256i indices = _mm256_add_epi32(offsets, _mm256_set1_epi32(static_cast<int>(i)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + written), indices);
+			written += LANE_TABLE.counts[mask];
+		}
+		return written;
+	}
+
+#endif
+
+	FrustumCuller::FrustumCuller()
+		: kernel(is_supported(Kernel::AVX2) ? Kernel::AVX2 : is_supported(Kernel::SSE) ? Kernel::SSE : Kernel::SCALAR)
+	{
+	}
+
+	std::uint32_t FrustumCuller::add(const glm::vec3& min, const glm::vec3& max, float sphere_radius)
+	{
+		// Padding objects have no extent and a sphere of negative infinite radius, so every plane rejects them
+		if (count % LANES == 0u) {
+			for (std::vector<float>* array : { &center_x, &center_y, &center_z, &extent_x, &extent_y, &extent_z }) {
+				array->resize(count + LANES, 0.0f);
+			}
+			radius.resize(count + LANES, -std::numeric_limits<float>::infinity());
+		}
+
+		auto object = static_cast<std::uint32_t>(count++);
+		set(object, min, max, sphere_radius);
+		return object;
+	}
+
+	void FrustumCuller::set(std::uint32_t object, const glm::vec3& min, const glm::vec3& max, float sphere_radius) noexcept
+	{
+		glm::vec3 center = (min + max) * 0.5f;
+		glm::vec3 extent = (max - min) * 0.5f;
+		center_x[object] = center.x;
+		center_y[object] = center.y;
+		center_z[object] = center.z;
+		extent_x[object] = extent.x;
+		extent_y[object] = extent.y;
+		extent_z[object] = extent.z;
+		radius[object] = sphere_radius;
+	}
+
+	void FrustumCuller::reserve(std::size_t capacity)
+	{
+		std::size_t padded = (capacity + LANES - 1u) / LANES * LANES;
+		for (std::vector<float>* array : { &center_x, &center_y, &center_z, &extent_x, &extent_y, &extent_z, &radius }) {
+			array->reserve(padded);
+		}
+	}
+
+	void FrustumCuller::clear() noexcept
+	{
+		for (std::vector<float>* array : { &center_x, &center_y, &center_z, &extent_x, &extent_y, &extent_z, &radius }) {
+			array->clear();
+		}
+		count = 0u;
+	}
+
+	std::size_t FrustumCuller::cull(const Frustum& frustum, IndexList& visible) const
+	{
+		// Kernels write whole steps of indices and keep the visible ones, so the list needs room for every lane.
+		// Its elements are left uninitialised, so once the capacity is there this neither allocates nor writes.
+		std::size_t padded_count = center_x.size();
+		visible.resize(padded_count);
+
+		CullPlanes planes(frustum);
+		CullArrays arrays{ center_x.data(), center_y.data(), center_z.data(), extent_x.data(), extent_y.data(), extent_z.data(), radius.data() };
+		std::size_t written = 0u;
+		switch (kernel) {
+#ifdef CULL_X86
+			case Kernel::AVX2:
+				written = cull_avx2(arrays, padded_count, planes, visible.data());
+				break;
+			case Kernel::SSE:
+				written = cull_sse(arrays, padded_count, planes, visible.data());
+				break;
+#endif
+			default:
+				written = cull_scalar(arrays, count, planes, visible.data());
+				break;
+		}
+
+		visible.resize(written);
+		return written;
+	}
+
+	void FrustumCuller::set_kernel(Kernel value)
+	{
+		if (!is_supported(value)) {
+			throw std::invalid_argument("Culling kernel is not supported by this CPU");
+		}
+		kernel = value;
+	}
+
+	bool FrustumCuller::is_supported(Kernel value) noexcept
+	{
+		switch (value) {
+			case Kernel::SCALAR:
+				return true;
+#ifdef CULL_X86
+			case Kernel::SSE:
+				// Required by x64 and by MSVC's default 32-bit code generation
+				return true;
+			case Kernel::AVX2: {
+#ifdef _MSC_VER
+				int info[4];
+				__cpuid(info, 0);
+				if (info[0] < 7) {
+					return false;
+				}
+				// The OS must also save the upper halves of the vector registers
+				__cpuid(info, 1);
+				bool fma = (info[2] & (1 << 12)) != 0;
+				bool os_saves_avx = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6u) == 6u;
+				__cpuidex(info, 7, 0);
+				return fma && os_saves_avx && (info[1] & (1 << 5)) != 0;
+#else
+				return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+			}
+#endif
+			default:
+				return false;
+		}
+	}
+
+	const char* FrustumCuller::get_name(Kernel value) noexcept
+	{
+		switch (value) {
+			case Kernel::SCALAR:
+				return "scalar";
+			case Kernel::SSE:
+				return "SSE";
+			case Kernel::AVX2:
+				return "AVX2";
+		}
+		return "unknown";
+	}
+
+} // namespace coral
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace coral {
+
+	/// Six planes bounding what a camera sees. A point p is inside when dot(plane.xyz, p) + plane.w >= 0 for
+	/// every plane; the normals are unit length, so that value is a distance.
+	struct Frustum {
+		std::array<glm::vec4, 6> planes;
+
+		/// Planes of a projection or view-projection matrix, in the space it transforms from. Clip depth runs
+		/// from -w to w as in OpenGL.
+		[[nodiscard]] static Frustum from_matrix(const glm::mat4& matrix) noexcept;
+
+		/// Whether a sphere is not wholly outside any one plane, the test FrustumCuller makes for spheres.
+		[[nodiscard]] bool intersects_sphere(const glm::vec3& center, float radius) const noexcept
+		{
+			for (const glm::vec4& plane : planes) {
+				if (glm::dot(glm::vec3{ plane }, center) + plane.w < -radius) {
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	/// Allocator whose vectors leave new elements uninitialised, so a vector can be resized to make room for
+	/// output that is about to be written without zeroing it first.
+	template <typename T>
+	struct UninitializedAllocator : std::allocator<T> {
+		template <typename U>
+		struct rebind {
+			using other = UninitializedAllocator<U>;
+		};
+
+		UninitializedAllocator() noexcept = default;
+
+		template <typename U>
+		UninitializedAllocator(const UninitializedAllocator<U>&) noexcept
+		{
+		}
+
+		template <typename U>
+		void construct(U* pointer) noexcept(std::is_nothrow_default_constructible_v<U>)
+		{
+			::new (static_cast<void*>(pointer)) U;
+		}
+
+		template <typename U, typename... Args>
+		void construct(U* pointer, Args&&... args)
+		{
+			::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+		}
+	};
+
+	/// Frustum culling of many objects at once. No GL calls, so it runs anywhere.
+	///
+	/// Each object has a box and a sphere around the box's centre, e.g. MeshBounds, stored as arrays of each
+	/// component so that SIMD kernels test eight objects per step with plain loads. An object is culled when
+	/// either shape lies wholly outside one plane. Results are a compact list of visible object indices, in
+	/// ascending order, ready to queue draws from.
+	class FrustumCuller {
+	public:
+
+		enum class Kernel {
+			SCALAR,
+			/// Four objects per instruction. Every x86 CPU this builds for has it.
+			SSE,
+			/// Eight objects per instruction, on CPUs with AVX2 and FMA.
+			AVX2,
+		};
+
+		/// Visible object indices. Kept between calls, it only allocates when the object count grows.
+		using IndexList = std::vector<std::uint32_t, UninitializedAllocator<std::uint32_t>>;
+
+		/// Objects tested per step of the widest kernel. Arrays are padded to a multiple of it with objects
+		/// that are never visible.
+		static constexpr std::size_t LANES = 8u;
+
+	private:
+
+		std::vector<float> center_x{};
+		std::vector<float> center_y{};
+		std::vector<float> center_z{};
+		std::vector<float> extent_x{};
+		std::vector<float> extent_y{};
+		std::vector<float> extent_z{};
+		std::vector<float> radius{};
+		std::size_t count = 0u;
+		Kernel kernel;
+
+	public:
+
+		/// Uses the widest kernel the CPU supports.
+		FrustumCuller();
+
+		/// Add an object with a box from min to max and a sphere of the given radius around the box's centre.
+		/// The sphere only helps when it is smaller than the box's half diagonal; by default only the box is
+		/// tested. Returns the object's index.
+		std::uint32_t add(const glm::vec3& min, const glm::vec3& max, float sphere_radius = std::numeric_limits<float>::infinity());
+
+		/// Move or resize an object.
+		void set(std::uint32_t object, const glm::vec3& min, const glm::vec3& max, float sphere_radius = std::numeric_limits<float>::infinity()) noexcept;
+
+		void reserve(std::size_t capacity);
+		void clear() noexcept;
+
+		/// Replace visible with the indices of the objects not wholly outside the frustum, and return how many.
+		std::size_t cull(const Frustum& frustum, IndexList& visible) const;
+
+		/// Kernel used by cull. Throws if the CPU does not support it.
+		void set_kernel(Kernel value);
+
+		[[nodiscard]] Kernel get_kernel() const noexcept { return kernel; }
+		[[nodiscard]] std::size_t get_count() const noexcept { return count; }
+
+		[[nodiscard]] static bool is_supported(Kernel value) noexcept;
+		[[nodiscard]] static const char* get_name(Kernel value) noexcept;
+
+	};
+
+} // namespace coral
@@ -0,0 +1,144 @@
+#include "GpuProfiler.h"
+
+#include "Util.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace coral {
+
+	GpuProfiler::GpuProfiler()
+	{
+		for (Frame& frame : frames) {
+			glGenQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+			frame.zones.reserve(MAX_ZONES);
+		}
+		open_zones.reserve(MAX_ZONES);
+	}
+
+	GpuProfiler::~GpuProfiler()
+	{
+		for (Frame& frame : frames) {
+			glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+		}
+	}
+
+	void GpuProfiler::begin_frame()
+	{
+		frame_index = (frame_index + 1) % FRAME_LATENCY;
+
+		Frame& frame = frames[frame_index];
+		if (frame.pending) {
+			resolve(frame);
+		}
+
+		frame.zones.clear();
+		open_zones.clear();
+	}
+
+	void GpuProfiler::end_frame()
+	{
+		while (!open_zones.empty()) {
+			pop_zone();
+		}
+		frames[frame_index].pending = !frames[frame_index].zones.empty();
+	}
+
+	void GpuProfiler::push_zone(const char* name)
+	{
+		Frame& frame = frames[frame_index];
+		if (frame.zones.size() == MAX_ZONES) {
+			// Out of queries this frame. Keep the stack balanced and drop the zone.
+			open_zones.push_back(MAX_ZONES);
+			return;
+		}
+
+		std::size_t index = frame.zones.size();
+		frame.zones.push_back(Zone{ name, static_cast<unsigned int>(open_zones.size()) });
+		open_zones.push_back(index);
+
+		glQueryCounter(frame.queries[index * 2], GL_TIMESTAMP);
+		frame.last_query = frame.queries[index * 2];
+	}
+
+	void GpuProfiler::pop_zone()
+	{
+		if (open_zones.empty()) {
+			return;
+		}
+
+		std::size_t index = open_zones.back();
+		open_zones.pop_back();
+
+		if (index != MAX_ZONES) {
+			Frame& frame = frames[frame_index];
+			glQueryCounter(frame.queries[index * 2 + 1], GL_TIMESTAMP);
+			frame.last_query = frame.queries[index * 2 + 1];
+		}
+	}
+
+	void GpuProfiler::resolve(Frame& frame)
+	{
+		frame.pending = false;
+
+		// Timestamps complete in submission order, so the query issued last being ready implies all are.
+		GLint available = GL_FALSE;
+		glGetQueryObjectiv(frame.last_query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			++dropped_frames;
+			return;
+		}
+
+		for (std::size_t i = 0; i < frame.zones.size(); ++i) {
+			GLuint64 begin, end;
+			glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+
+			auto [it, inserted] = history.try_emplace(frame.zones[i].name);
+			if (inserted) {
+				it->second.order = history.size();
+			}
+			it->second.depth = frame.zones[i].depth;
+			it->second.samples.push(static_cast<float>(end - begin) / 1.0e6f);
+		}
+	}
+
+	float GpuProfiler::get_average(const std::string& name) const
+	{
+		auto it = history.find(name);
+		if (it == history.end() || it->second.samples.get_size() == 0) {
+			return -1.0f;
+		}
+
+		const auto& samples = it->second.samples;
+		float sum = 0.0f;
+		for (std::size_t i = 0; i < samples.get_size(); ++i) {
+			sum += samples.recent(i);
+		}
+		return sum / static_cast<float>(samples.get_size());
+	}
+
+	void GpuProfiler::print() const
+	{
+		Util::print_divider("GPU Zones Begin");
+
+		std::vector<const std::pair<const std::string, ZoneHistory>*> sorted;
+		sorted.reserve(history.size());
+		for (const auto& entry : history) {
+			sorted.push_back(&entry);
+		}
+		std::sort(sorted.begin(), sorted.end(), [](auto a, auto b) { return a->second.order < b->second.order; });
+
+		std::cout << std::fixed << std::setprecision(3);
+		for (auto entry : sorted) {
+			std::cout << std::string(entry->second.depth * 2, ' ') << entry->first << ": "
+				<< get_average(entry->first) << " ms\n";
+		}
+		std::cout << std::defaultfloat;
+		std::cout << "Frames dropped waiting on results: " << dropped_frames << '\n';
+
+		Util::print_divider("GPU Zones End");
+	}
+
+} // namespace coral
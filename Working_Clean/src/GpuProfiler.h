@@ -0,0 +1,106 @@
+#pragma once
+
+#include "RingBuffer.h"
+
+#include <glew/glew.h>
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace coral {
+
+	/// Measures GPU time of named, nestable zones with timestamp queries.
+	/// Queries are read back several frames later and only once available, so the CPU never waits on the GPU.
+	class GpuProfiler {
+	public:
+
+		/// Number of frames in flight before a frame's queries are read back.
+		static constexpr std::size_t FRAME_LATENCY = 4u;
+		static constexpr std::size_t MAX_ZONES = 64u;
+
+		/// Number of resolved samples each zone average is taken over.
+		static constexpr std::size_t AVERAGE_WINDOW = 64u;
+
+	private:
+
+		struct Zone {
+			const char* name;
+			unsigned int depth;
+		};
+
+		struct Frame {
+			std::array<GLuint, MAX_ZONES * 2> queries{};
+			std::vector<Zone> zones{};
+			/// Query issued most recently. Zones nest, so this is often an outer zone's end rather than the last slot.
+			GLuint last_query = 0u;
+			bool pending = false;
+		};
+
+		struct ZoneHistory {
+			RingBuffer<float, AVERAGE_WINDOW> samples{};
+			unsigned int depth = 0u;
+			std::size_t order = 0u;
+		};
+
+		std::array<Frame, FRAME_LATENCY> frames{};
+		std::size_t frame_index = 0u;
+		std::vector<std::size_t> open_zones{};
+
+		std::unordered_map<std::string, ZoneHistory> history{};
+		std::size_t dropped_frames = 0u;
+
+	public:
+
+		GpuProfiler();
+		~GpuProfiler();
+
+		GpuProfiler(const GpuProfiler&) = delete;
+		GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+		/// Read back the oldest frame in flight if its results are ready, then start recording a new frame.
+		void begin_frame();
+
+		void end_frame();
+
+		/// Open a zone. The name must outlive the frame it is recorded in, typically a string literal.
+		void push_zone(const char* name);
+
+		void pop_zone();
+
+		/// Average GPU time of a zone in milliseconds, or a negative value if the zone has no samples yet.
+		[[nodiscard]] float get_average(const std::string& name) const;
+
+		void print() const;
+
+	private:
+
+		void resolve(Frame& frame);
+
+	};
+
+	/// Records a GPU profiler zone for the lifetime of the object.
+	class GpuZone {
+
+		GpuProfiler& profiler;
+
+	public:
+
+		GpuZone(GpuProfiler& profiler, const char* name)
+			: profiler(profiler)
+		{
+			profiler.push_zone(name);
+		}
+
+		~GpuZone()
+		{
+			profiler.pop_zone();
+		}
+
+		GpuZone(const GpuZone&) = delete;
+		GpuZone& operator=(const GpuZone&) = delete;
+
+	};
+
+} // namespace coral
@@ -0,0 +1,127 @@
+#include "HeadlessContext.h"
+
+#include "Util.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <sdl/SDL.h>
+#else
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+namespace coral {
+
+#ifdef _WIN32
+
+	HeadlessContext::HeadlessContext()
+	{
+		if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+			Util::throw_exception("Failed to init SDL video", SDL_GetError());
+		}
+
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 5);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+
+		window = SDL_CreateWindow("Headless", 0, 0, 1, 1, SDL_WINDOW_HIDDEN | SDL_WINDOW_OPENGL);
+		if (window == nullptr) {
+			SDL_QuitSubSystem(SDL_INIT_VIDEO);
+			Util::throw_exception("Failed to create hidden window", SDL_GetError());
+		}
+
+		context = SDL_GL_CreateContext(window);
+		if (context == nullptr) {
+			SDL_DestroyWindow(window);
+			SDL_QuitSubSystem(SDL_INIT_VIDEO);
+			Util::throw_exception("Failed to create headless context", SDL_GetError());
+		}
+	}
+
+	HeadlessContext::~HeadlessContext()
+	{
+		SDL_GL_DeleteContext(context);
+		SDL_DestroyWindow(window);
+		SDL_QuitSubSystem(SDL_INIT_VIDEO);
+	}
+
+#else
+
+	HeadlessContext::HeadlessContext()
+	{
+		auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+		EGLDisplay egl_display = EGL_NO_DISPLAY;
+		if (get_platform_display != nullptr) {
+			egl_display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+		}
+		if (egl_display == EGL_NO_DISPLAY) {
+			egl_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		}
+		if (egl_display == EGL_NO_DISPLAY || !eglInitialize(egl_display, nullptr, nullptr)) {
+			throw std::runtime_error("Failed to initialize EGL display");
+		}
+		display = egl_display;
+
+		static const EGLint CONFIG_ATTRIBUTES[] = {
+			EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_RED_SIZE, 8,
+			EGL_GREEN_SIZE, 8,
+			EGL_BLUE_SIZE, 8,
+			EGL_ALPHA_SIZE, 8,
+			EGL_NONE,
+		};
+
+		EGLConfig config;
+		EGLint config_count = 0;
+		if (!eglChooseConfig(egl_display, CONFIG_ATTRIBUTES, &config, 1, &config_count) || config_count == 0) {
+			eglTerminate(egl_display);
+			throw std::runtime_error("No suitable EGL config");
+		}
+
+		static const EGLint CONTEXT_ATTRIBUTES[] = {
+			EGL_CONTEXT_MAJOR_VERSION, 4,
+			EGL_CONTEXT_MINOR_VERSION, 5,
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE,
+		};
+
+		eglBindAPI(EGL_OPENGL_API);
+		EGLContext egl_context = eglCreateContext(egl_display, config, EGL_NO_CONTEXT, CONTEXT_ATTRIBUTES);
+		if (egl_context == EGL_NO_CONTEXT) {
+			eglTerminate(egl_display);
+			throw std::runtime_error("Failed to create EGL context");
+		}
+		context = egl_context;
+
+		// Surfaceless when supported, otherwise fall back to a tiny pbuffer to make the context current.
+		if (!eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, egl_context)) {
+			static const EGLint PBUFFER_ATTRIBUTES[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+			EGLSurface pbuffer = eglCreatePbufferSurface(egl_display, config, PBUFFER_ATTRIBUTES);
+			if (pbuffer == EGL_NO_SURFACE || !eglMakeCurrent(egl_display, pbuffer, pbuffer, egl_context)) {
+				if (pbuffer != EGL_NO_SURFACE) {
+					eglDestroySurface(egl_display, pbuffer);
+				}
+				eglDestroyContext(egl_display, egl_context);
+				eglTerminate(egl_display);
+				throw std::runtime_error("Failed to make EGL context current");
+			}
+			surface = pbuffer;
+		}
+	}
+
+	HeadlessContext::~HeadlessContext()
+	{
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (surface != nullptr) {
+			eglDestroySurface(display, surface);
+		}
+		eglDestroyContext(display, context);
+		eglTerminate(display);
+	}
+
+#endif
+
+} // namespace coral
@@ -0,0 +1,30 @@
+#pragma once
+
+namespace coral {
+
+	/// OpenGL 4.5 core context with no visible window, for running on machines without a display.
+	/// Uses an EGL surfaceless context where available (Mesa llvmpipe works) and a hidden SDL window on Windows.
+	/// All rendering must go to a framebuffer object since there is no default framebuffer to present.
+	class HeadlessContext {
+
+#ifdef _WIN32
+		struct SDL_Window* window = nullptr;
+		void* context = nullptr;
+#else
+		void* display = nullptr;
+		void* context = nullptr;
+		/// Pbuffer made current when surfaceless contexts are not supported.
+		void* surface = nullptr;
+#endif
+
+	public:
+
+		HeadlessContext();
+		~HeadlessContext();
+
+		HeadlessContext(const HeadlessContext&) = delete;
+		HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+	};
+
+} // namespace coral
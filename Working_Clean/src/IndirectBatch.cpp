@@ -0,0 +1,94 @@
+#include "IndirectBatch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace coral {
+
+	IndirectBatch::IndirectBatch(std::uint32_t max_draws, const char* label)
+		: commands(sizeof(DrawElementsIndirectCommand) * max_draws, label)
+	{
+		draws.reserve(max_draws);
+	}
+
+	void IndirectBatch::add(const MeshPool::Mesh& mesh, std::uint32_t object_index, std::uint32_t instance_count)
+	{
+		Draw draw;
+		bool indexed = mesh.index_count > 0u;
+		draw.page = mesh.page;
+		draw.index_type = indexed ? mesh.index_type : GL_NONE;
+		draw.command.count = indexed ? mesh.index_count : mesh.vertex_count;
+		draw.command.instance_count = instance_count;
+		draw.command.first_index = indexed ? mesh.first_index : mesh.base_vertex;
+		draw.command.base_vertex = static_cast<GLint>(mesh.base_vertex);
+		draw.command.base_instance = object_index;
+		draws.push_back(draw);
+	}
+
+	void IndirectBatch::submit(MeshPool& pool, GLenum mode)
+	{
+		if (draws.empty()) {
+			return;
+		}
+		if (pool.get_format().has_quantized_position()) {
+			// Constant attributes hold one mesh's quantization, and a multi-draw reads many meshes
+			draws.clear();
+			throw std::invalid_argument("Indirect batches cannot draw meshes with quantized positions");
+		}
+
+		// Commands are all 4-byte aligned, so the remaining space is exact
+		GLsizeiptr size = sizeof(DrawElementsIndirectCommand) * draws.size();
+		if (size > commands.get_remaining()) {
+			draws.clear();
+			throw std::runtime_error("Too many draws queued in one frame of an indirect batch");
+		}
+		StreamBuffer::Allocation allocation = commands.allocate(size, alignof(DrawElementsIndirectCommand));
+
+		// Group by the buffers each draw reads from, keeping submission order within a group
+		std::stable_sort(draws.begin(), draws.end(), [](const Draw& a, const Draw& b) {
+			return a.page != b.page ? a.page < b.page : a.index_type < b.index_type;
+		});
+
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands.get_buffer());
+
+		GLsizeiptr cursor = 0;
+		std::size_t first = 0u;
+		while (first < draws.size()) {
+			std::size_t last = first;
+			while (last < draws.size() && draws[last].page == draws[first].page && draws[last].index_type == draws[first].index_type) {
+				++last;
+			}
+
+			GLintptr offset = allocation.offset + cursor;
+			GLsizei count = static_cast<GLsizei>(last - first);
+			GLenum index_type = draws[first].index_type;
+			if (index_type != GL_NONE) {
+				for (std::size_t i = first; i < last; ++i) {
+					std::memcpy(allocation.data + cursor, &draws[i].command, sizeof(DrawElementsIndirectCommand));
+					cursor += sizeof(DrawElementsIndirectCommand);
+				}
+			} else {
+				for (std::size_t i = first; i < last; ++i) {
+					const DrawElementsIndirectCommand& source = draws[i].command;
+					DrawArraysIndirectCommand command{ source.count, source.instance_count, source.first_index, source.base_instance };
+					std::memcpy(allocation.data + cursor, &command, sizeof(DrawArraysIndirectCommand));
+					cursor += sizeof(DrawArraysIndirectCommand);
+				}
+			}
+
+			pool.bind_page(draws[first].page);
+			if (index_type != GL_NONE) {
+				glMultiDrawElementsIndirect(mode, index_type, reinterpret_cast<const void*>(offset), count, 0);
+			} else {
+				glMultiDrawArraysIndirect(mode, reinterpret_cast<const void*>(offset), count, 0);
+			}
+
+			first = last;
+		}
+
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, NULL);
+		draws.clear();
+	}
+
+} // namespace coral
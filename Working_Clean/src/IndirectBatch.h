@@ -0,0 +1,73 @@
+#pragma once
+
+#include "MeshPool.h"
+#include "StreamBuffer.h"
+
+#include <glew/glew.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace coral {
+
+	/// Layouts read by glMultiDrawElementsIndirect and glMultiDrawArraysIndirect.
+	struct DrawElementsIndirectCommand {
+		GLuint count;
+		GLuint instance_count;
+		GLuint first_index;
+		GLint base_vertex;
+		GLuint base_instance;
+	};
+
+	struct DrawArraysIndirectCommand {
+		GLuint count;
+		GLuint instance_count;
+		GLuint first;
+		GLuint base_instance;
+	};
+
+	/// Collects draws of pooled meshes and submits them with one multi-draw-indirect call per pool page and
+	/// index type.
+	///
+	/// Each draw carries an object index passed as its base instance, so shaders find per-object data at
+	/// `gl_BaseInstanceARB + gl_InstanceID` (ARB_shader_draw_parameters); `gl_DrawIDARB` gives the position
+	/// of the draw within its call. Commands are written to a stream buffer.
+	class IndirectBatch {
+
+		struct Draw {
+			std::uint32_t page;
+			/// GL_NONE for non-indexed meshes.
+			GLenum index_type;
+			DrawElementsIndirectCommand command;
+		};
+
+		StreamBuffer commands;
+		std::vector<Draw> draws{};
+
+	public:
+
+		/// At most max_draws draws can be submitted per frame.
+		IndirectBatch(std::uint32_t max_draws, const char* label);
+
+		IndirectBatch(const IndirectBatch&) = delete;
+		IndirectBatch& operator=(const IndirectBatch&) = delete;
+
+		/// Move to the next region of the command buffer, waiting only if the GPU is still reading it.
+		void begin_frame() { commands.begin_frame(); }
+
+		/// Queue a draw of a mesh. Instances read object data from object_index onwards.
+		void add(const MeshPool::Mesh& mesh, std::uint32_t object_index, std::uint32_t instance_count = 1u);
+
+		/// Draw everything queued since the last submit with the current program. The pool must be bound.
+		/// Throws for pools with quantized positions, whose per-mesh quantization cannot vary within one call.
+		void submit(MeshPool& pool, GLenum mode);
+
+		/// Fence the current region. Call once all of this frame's submits have been issued.
+		void end_frame() { commands.end_frame(); }
+
+		[[nodiscard]] std::size_t get_queued_count() const noexcept { return draws.size(); }
+
+	};
+
+} // namespace coral
@@ -0,0 +1,232 @@
+#include "MeshFile.h"
+
+#include "Util.h"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace coral {
+
+	static_assert(std::is_trivially_copyable_v<MeshFileHeader> && std::is_standard_layout_v<MeshFileHeader>, "Header is read in place");
+
+	/// Whether every index refers to one of vertex_count vertices.
+	template <typename T>
+	static bool are_indices_in_range(const void* indices, std::uint32_t index_count, std::uint32_t vertex_count) noexcept
+	{
+		const T* begin = static_cast<const T*>(indices);
+		return std::all_of(begin, begin + index_count, [=](T index) { return index < vertex_count; });
+	}
+
+	MeshFile::MeshFile(const std::string& path)
+		: view(path, FileAccess::WILL_NEED), header(reinterpret_cast<const MeshFileHeader*>(view.get_data()))
+	{
+		if (view.get_size() < sizeof(MeshFileHeader) || header->magic != MAGIC) {
+			Util::throw_exception("Not a mesh file", path.c_str());
+		}
+		if (header->version != VERSION) {
+			Util::throw_exception("Unsupported mesh file version", path.c_str());
+		}
+
+		std::uint32_t stride = 0u;
+		switch (header->vertex_format) {
+			case MeshFileVertexFormat::POSITION:
+				stride = sizeof(MeshPool::Vertex);
+				break;
+			case MeshFileVertexFormat::PACKED:
+				stride = sizeof(PackedVertex);
+				break;
+		}
+		if (stride == 0u || header->vertex_stride != stride || header->vertex_count == 0u) {
+			Util::throw_exception("Unsupported vertex format in mesh file", path.c_str());
+		}
+
+		bool short_indices = header->index_type == GL_UNSIGNED_SHORT && header->vertex_count <= MeshPool::MAX_SHORT_INDEXED_VERTICES;
+		if (!short_indices && header->index_type != GL_UNSIGNED_INT) {
+			Util::throw_exception("Invalid index type in mesh file", path.c_str());
+		}
+
+		// Everything below is read in place, so every section must lie inside the file at its stated size
+		const std::uint64_t expected_sizes[MeshSection::COUNT] = {
+			std::uint64_t{ stride } * header->vertex_count,
+			std::uint64_t{ MeshPool::get_index_size(header->index_type) } * header->index_count,
+			std::uint64_t{ sizeof(Meshlet) } * header->meshlet_count,
+			sizeof(MeshBounds),
+			std::uint64_t{ sizeof(LodLevel) } * header->lod_count,
+		};
+		for (std::uint32_t i = 0u; i < MeshSection::COUNT; ++i) {
+			const MeshFileSection& section = header->sections[i];
+			if (section.size != expected_sizes[i] || section.offset % SECTION_ALIGNMENT != 0u
+				|| section.offset > view.get_size() || section.size > view.get_size() - section.offset) {
+				Util::throw_exception("Corrupt section table in mesh file", path.c_str());
+			}
+		}
+
+		// Indices go to the GPU unchecked, so a corrupt file must not reach past the vertices
+		const void* indices = get_section(MeshSection::INDICES);
+		bool indices_valid = header->index_type == GL_UNSIGNED_SHORT ? are_indices_in_range<std::uint16_t>(indices, header->index_count, header->vertex_count)
+			: are_indices_in_range<std::uint32_t>(indices, header->index_count, header->vertex_count);
+		if (!indices_valid) {
+			Util::throw_exception("Index outside the vertices in mesh file", path.c_str());
+		}
+
+		const LodLevel* lods = get_lods();
+		for (std::uint32_t i = 0u; i < header->lod_count; ++i) {
+			if (lods[i].first_index > header->index_count || lods[i].index_count > header->index_count - lods[i].first_index) {
+				Util::throw_exception("Level of detail outside the indices in mesh file", path.c_str());
+			}
+		}
+
+		// Without levels the whole mesh is level 0
+		const Meshlet* meshlets = get_meshlets();
+		std::uint32_t level_count = std::max(header->lod_count, 1u);
+		for (std::uint32_t i = 0u; i < header->meshlet_count; ++i) {
+			if (meshlets[i].first_index > header->index_count || meshlets[i].index_count > header->index_count - meshlets[i].first_index
+				|| meshlets[i].index_count % 3u != 0u || meshlets[i].lod >= level_count || (i > 0u && meshlets[i].lod < meshlets[i - 1u].lod)) {
+				Util::throw_exception("Invalid meshlet in mesh file", path.c_str());
+			}
+		}
+	}
+
+	const void* MeshFile::get_section(std::uint32_t section) const noexcept
+	{
+		const MeshFileSection& entry = header->sections[section];
+		return entry.size > 0u ? view.get_data() + entry.offset : nullptr;
+	}
+
+	const MeshBounds& MeshFile::get_bounds() const noexcept
+	{
+		return *static_cast<const MeshBounds*>(get_section(MeshSection::BOUNDS));
+	}
+
+	const LodLevel* MeshFile::get_lods() const noexcept
+	{
+		return static_cast<const LodLevel*>(get_section(MeshSection::LODS));
+	}
+
+	const Meshlet* MeshFile::get_meshlets() const noexcept
+	{
+		return static_cast<const Meshlet*>(get_section(MeshSection::MESHLETS));
+	}
+
+	MeshFileVertexFormat MeshFile::get_vertex_format(const VertexFormat& format)
+	{
+		if (format.is<MeshPool::Vertex>()) {
+			return MeshFileVertexFormat::POSITION;
+		}
+		if (format.is<PackedVertex>()) {
+			return MeshFileVertexFormat::PACKED;
+		}
+		throw std::invalid_argument("Vertex format cannot be stored in a mesh file");
+	}
+
+	void MeshFile::write(const std::string& path, const IndexedMesh& mesh, const std::vector<LodLevel>& lods, const std::vector<Meshlet>& meshlets)
+	{
+		static_assert(sizeof(MeshPool::Vertex) == sizeof(glm::vec3), "Positions are read as a plain array");
+
+		MeshBounds bounds = compute_bounds(reinterpret_cast<const glm::vec3*>(mesh.vertices.data()), mesh.vertices.size());
+		write(path, MeshFileVertexFormat::POSITION, mesh.vertices.data(), sizeof(MeshPool::Vertex), static_cast<std::uint32_t>(mesh.vertices.size()),
+			mesh.indices, PositionQuantization{}, bounds, lods, meshlets);
+	}
+
+	void MeshFile::write(const std::string& path, const PackedMesh& mesh, const std::vector<LodLevel>& lods, const std::vector<Meshlet>& meshlets)
+	{
+		std::vector<glm::vec3> positions;
+		positions.reserve(mesh.vertices.size());
+		for (const PackedVertex& vertex : mesh.vertices) {
+			positions.push_back(VertexPacking::dequantize(vertex.position, mesh.quantization));
+		}
+
+		MeshBounds bounds = compute_bounds(positions.data(), positions.size());
+		write(path, MeshFileVertexFormat::PACKED, mesh.vertices.data(), sizeof(PackedVertex), static_cast<std::uint32_t>(mesh.vertices.size()),
+			mesh.indices, mesh.quantization, bounds, lods, meshlets);
+	}
+
+	void MeshFile::write(const std::string& path, MeshFileVertexFormat vertex_format, const void* vertices, std::uint32_t vertex_stride, std::uint32_t vertex_count,
+		const std::vector<MeshPool::Index>& indices, const PositionQuantization& quantization, const MeshBounds& bounds, const std::vector<LodLevel>& lods,
+		const std::vector<Meshlet>& meshlets)
+	{
+		if (vertex_count == 0u) {
+			Util::throw_exception("Cannot write a mesh file without vertices", path.c_str());
+		}
+
+		MeshFileHeader header{};
+		header.magic = MAGIC;
+		header.version = VERSION;
+		header.vertex_format = vertex_format;
+		header.vertex_stride = vertex_stride;
+		header.vertex_count = vertex_count;
+		header.index_count = static_cast<std::uint32_t>(indices.size());
+		header.index_type = vertex_count <= MeshPool::MAX_SHORT_INDEXED_VERTICES ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+		header.meshlet_count = static_cast<std::uint32_t>(meshlets.size());
+		header.lod_count = static_cast<std::uint32_t>(lods.size());
+		header.quantization = quantization;
+
+		// Stored at the width MeshPool would pick, so the section can be uploaded as is
+		std::vector<std::uint16_t> narrow;
+		const void* index_data = indices.data();
+		if (header.index_type == GL_UNSIGNED_SHORT) {
+			narrow.assign(indices.begin(), indices.end());
+			index_data = narrow.data();
+		}
+
+		const void* section_data[MeshSection::COUNT] = { vertices, index_data, meshlets.data(), &bounds, lods.data() };
+		const std::uint64_t section_sizes[MeshSection::COUNT] = {
+			std::uint64_t{ vertex_stride } * vertex_count,
+			std::uint64_t{ MeshPool::get_index_size(header.index_type) } * indices.size(),
+			std::uint64_t{ sizeof(Meshlet) } * meshlets.size(),
+			sizeof(MeshBounds),
+			std::uint64_t{ sizeof(LodLevel) } * lods.size(),
+		};
+
+		auto align = [](std::uint64_t offset) { return (offset + SECTION_ALIGNMENT - 1u) / SECTION_ALIGNMENT * SECTION_ALIGNMENT; };
+		std::uint64_t offset = align(sizeof(MeshFileHeader));
+		for (std::uint32_t i = 0u; i < MeshSection::COUNT; ++i) {
+			header.sections[i] = MeshFileSection{ offset, section_sizes[i] };
+			offset = align(offset + section_sizes[i]);
+		}
+
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out.is_open()) {
+			Util::throw_exception("Failed to open mesh file for writing", path.c_str());
+		}
+
+		static constexpr char PADDING[SECTION_ALIGNMENT] = {};
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		std::uint64_t written = sizeof(header);
+		for (std::uint32_t i = 0u; i < MeshSection::COUNT; ++i) {
+			out.write(PADDING, static_cast<std::streamsize>(header.sections[i].offset - written));
+			out.write(static_cast<const char*>(section_data[i]), static_cast<std::streamsize>(section_sizes[i]));
+			written = header.sections[i].offset + section_sizes[i];
+		}
+
+		if (!out) {
+			Util::throw_exception("Failed to write mesh file", path.c_str());
+		}
+	}
+
+	MeshBounds MeshFile::compute_bounds(const glm::vec3* positions, std::size_t count)
+	{
+		if (count == 0u) {
+			return MeshBounds{};
+		}
+
+		MeshBounds bounds{ positions[0], positions[0], glm::vec3{ 0.0f }, 0.0f };
+		for (std::size_t i = 1u; i < count; ++i) {
+			bounds.min = glm::min(bounds.min, positions[i]);
+			bounds.max = glm::max(bounds.max, positions[i]);
+		}
+
+		// Sphere around the box centre; loose, but cheap and stable
+		bounds.center = (bounds.min + bounds.max) * 0.5f;
+		for (std::size_t i = 0u; i < count; ++i) {
+			bounds.radius = std::max(bounds.radius, glm::distance(bounds.center, positions[i]));
+		}
+		return bounds;
+	}
+
+} // namespace coral
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "FileView.h"
+#include "MeshLod.h"
+#include "MeshUtil.h"
+#include "Meshlet.h"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace coral {
+
+	/// Vertex struct stored in a mesh file.
+	enum class MeshFileVertexFormat : std::uint32_t {
+		/// MeshPool::Vertex
+		POSITION = 1,
+		/// PackedVertex
+		PACKED = 2,
+	};
+
+	struct MeshSection {
+		enum : std::uint32_t {
+			VERTICES,
+			/// GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, per the header.
+			INDICES,
+			/// meshlet_count Meshlet, ordered by level of detail. Empty for a mesh without meshlets.
+			MESHLETS,
+			/// One MeshBounds.
+			BOUNDS,
+			/// lod_count LodLevel, finest first. Empty for a mesh without levels of detail.
+			LODS,
+			COUNT,
+		};
+	};
+
+	struct MeshFileSection {
+		/// From the start of the file, a multiple of MeshFile::SECTION_ALIGNMENT.
+		std::uint64_t offset;
+		std::uint64_t size;
+	};
+
+	/// Fixed header at the start of every mesh file. Little endian.
+	struct MeshFileHeader {
+		std::array<char, 4> magic;
+		std::uint32_t version;
+		MeshFileVertexFormat vertex_format;
+		std::uint32_t vertex_stride;
+		std::uint32_t vertex_count;
+		std::uint32_t index_count;
+		std::uint32_t index_type;
+		std::uint32_t meshlet_count;
+		std::uint32_t lod_count;
+		/// Zero. Keeps the sections 8-byte aligned without implicit padding.
+		std::uint32_t reserved;
+		PositionQuantization quantization;
+		std::array<MeshFileSection, MeshSection::COUNT> sections;
+	};
+
+	struct MeshBounds {
+		glm::vec3 min;
+		glm::vec3 max;
+		glm::vec3 center;
+		float radius;
+	};
+
+	/// Cooked mesh, laid out so that a memory mapped file can be uploaded without parsing. The header is
+	/// followed by aligned sections of vertices and indices already in the format MeshPool stores them in,
+	/// which are handed to the GL as they are. Write files with the MeshCooker tool or MeshFile::write.
+	class MeshFile {
+	public:
+
+		static constexpr std::array<char, 4> MAGIC = { 'C', 'M', 'S', 'H' };
+		static constexpr std::uint32_t VERSION = 2u;
+		static constexpr std::size_t SECTION_ALIGNMENT = 64u;
+
+	private:
+
+		FileView view;
+		const MeshFileHeader* header;
+
+	public:
+
+		/// Map a file and validate its header. Throws if the file is not a mesh file of this version.
+		explicit MeshFile(const std::string& path);
+
+		[[nodiscard]] const MeshFileHeader& get_header() const noexcept { return *header; }
+
+		/// Pointer into the mapped file, or null for an empty section.
+		[[nodiscard]] const void* get_section(std::uint32_t section) const noexcept;
+
+		[[nodiscard]] const MeshBounds& get_bounds() const noexcept;
+
+		/// The header's lod_count levels of detail, or null if there are none.
+		[[nodiscard]] const LodLevel* get_lods() const noexcept;
+
+		/// The header's meshlet_count meshlets, or null if there are none.
+		[[nodiscard]] const Meshlet* get_meshlets() const noexcept;
+
+		/// Mesh file tag of a pool's format. Throws for formats mesh files cannot hold.
+		[[nodiscard]] static MeshFileVertexFormat get_vertex_format(const VertexFormat& format);
+
+		/// Levels of detail and meshlets index into the mesh's indices, e.g. those of a LodChain split by MeshletBuilder.
+		static void write(const std::string& path, const IndexedMesh& mesh, const std::vector<LodLevel>& lods = {}, const std::vector<Meshlet>& meshlets = {});
+		static void write(const std::string& path, const PackedMesh& mesh, const std::vector<LodLevel>& lods = {}, const std::vector<Meshlet>& meshlets = {});
+
+	private:
+
+		static void write(const std::string& path, MeshFileVertexFormat vertex_format, const void* vertices, std::uint32_t vertex_stride, std::uint32_t vertex_count,
+			const std::vector<MeshPool::Index>& indices, const PositionQuantization& quantization, const MeshBounds& bounds, const std::vector<LodLevel>& lods,
+			const std::vector<Meshlet>& meshlets);
+
+		static MeshBounds compute_bounds(const glm::vec3* positions, std::size_t count);
+
+	};
+
+} // namespace coral
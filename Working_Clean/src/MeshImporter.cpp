@@ -0,0 +1,1238 @@
+#include "MeshImporter.h"
+
+#include "FileView.h"
+#include "Util.h"
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/matrix.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace coral {
+
+	/// OBJ files are split into chunks of at least this size, so small files are read by one thread.
+	static constexpr std::size_t OBJ_CHUNK_SIZE = std::size_t{ 1u } << 20u;
+
+	/// glTF accessors are converted in ranges of this many elements, a multiple of three so index ranges hold whole triangles.
+	static constexpr std::size_t GLTF_RANGE_SIZE = std::size_t{ 3u } << 15u;
+
+	/// Exact in double, so mantissas below 2^53 scale with a single rounding.
+	static constexpr double POWERS_OF_TEN[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+	};
+
+	static bool is_digit(char c) noexcept
+	{
+		return static_cast<unsigned char>(c - '0') < 10u;
+	}
+
+	static bool is_space(char c) noexcept
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	static const char* skip_spaces(const char* p, const char* last) noexcept
+	{
+		while (p != last && is_space(*p)) {
+			++p;
+		}
+		return p;
+	}
+
+	const char* MeshImporter::parse_float(const char* first, const char* last, float& value) noexcept
+	{
+		const char* p = first;
+		bool negative = false;
+		if (p != last && (*p == '-' || *p == '+')) {
+			negative = *p == '-';
+			++p;
+		}
+
+		// 19 significant digits always fit in 64 bits; later digits only move the decimal point
+		std::uint64_t mantissa = 0u;
+		int significant_digits = 0;
+		int exponent = 0;
+		bool any_digits = false;
+		for (; p != last && is_digit(*p); ++p) {
+			any_digits = true;
+			if (significant_digits < 19) {
+				mantissa = mantissa * 10u + static_cast<std::uint64_t>(*p - '0');
+				significant_digits += mantissa != 0u;
+			} else {
+				++exponent;
+			}
+		}
+		if (p != last && *p == '.') {
+			++p;
+			for (; p != last && is_digit(*p); ++p) {
+				any_digits = true;
+				if (significant_digits < 19) {
+					mantissa = mantissa * 10u + static_cast<std::uint64_t>(*p - '0');
+					significant_digits += mantissa != 0u;
+					--exponent;
+				}
+			}
+		}
+		if (!any_digits) {
+			return first;
+		}
+
+		// An 'e' without digits after it is not part of the number
+		if (p != last && (*p == 'e' || *p == 'E')) {
+			const char* q = p + 1;
+			bool exponent_negative = false;
+			if (q != last && (*q == '-' || *q == '+')) {
+				exponent_negative = *q == '-';
+				++q;
+			}
+			if (q != last && is_digit(*q)) {
+				int written_exponent = 0;
+				for (; q != last && is_digit(*q); ++q) {
+					written_exponent = std::min(written_exponent * 10 + (*q - '0'), 100000);
+				}
+				exponent += exponent_negative ? -written_exponent : written_exponent;
+				p = q;
+			}
+		}
+
+		double result = static_cast<double>(mantissa);
+		if (mantissa != 0u && exponent != 0) {
+			if (exponent < 0 && exponent >= -22) {
+				result /= POWERS_OF_TEN[-exponent];
+			} else if (exponent > 0 && exponent <= 22) {
+				result *= POWERS_OF_TEN[exponent];
+			} else {
+				result *= std::pow(10.0, exponent);
+			}
+		}
+		value = static_cast<float>(negative ? -result : result);
+		return p;
+	}
+
+	/// Integer counterpart of parse_float, for OBJ face indices.
+	static const char* parse_integer(const char* first, const char* last, std::int64_t& value) noexcept
+	{
+		const char* p = first;
+		bool negative = false;
+		if (p != last && (*p == '-' || *p == '+')) {
+			negative = *p == '-';
+			++p;
+		}
+
+		const char* digits = p;
+		std::int64_t result = 0;
+		for (; p != last && is_digit(*p); ++p) {
+			result = std::min<std::int64_t>(result * 10 + (*p - '0'), std::numeric_limits<std::int32_t>::max());
+		}
+		if (p == digits) {
+			return first;
+		}
+
+		value = negative ? -result : result;
+		return p;
+	}
+
+	MeshImporter::MeshImporter(unsigned int thread_count)
+		: threads(thread_count)
+	{
+	}
+
+	ImportedMesh MeshImporter::import(const std::string& path)
+	{
+		std::string extension = path.substr(std::min(path.find_last_of('.'), path.size()));
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+		if (extension == ".obj") {
+			return import_obj(path);
+		}
+		if (extension == ".gltf" || extension == ".glb") {
+			return import_gltf(path);
+		}
+		Util::throw_exception("Unsupported model file extension", path.c_str());
+		return ImportedMesh{};
+	}
+
+	// ---- Wavefront OBJ
+
+	/// Face corner as 0-based position, UV and normal indices into the whole file.
+	struct ObjCorner {
+		std::int64_t position;
+		std::int64_t uv;
+		std::int64_t normal;
+	};
+
+	/// Corner component left out, as in "f 1//1".
+	static constexpr std::int64_t OBJ_NONE = std::numeric_limits<std::int64_t>::min();
+
+	/// Negative OBJ indices count back from the end of the chunk being parsed, so until earlier chunks are counted
+	/// they are stored relative to the chunk start, offset by this to tell them apart from absolute indices.
+	static constexpr std::int64_t OBJ_RELATIVE_BIAS = std::int64_t{ 1 } << 40;
+
+	/// Everything parsed from one range of whole lines.
+	struct ObjChunk {
+		std::vector<glm::vec3> positions{};
+		std::vector<glm::vec2> uvs{};
+		std::vector<glm::vec3> normals{};
+		/// Three per triangle, with polygons split into fans.
+		std::vector<ObjCorner> corners{};
+		/// Corners whose UV or normal is missing or has the same index as the position, which lets the file
+		/// be read without welding.
+		std::size_t uv_missing = 0u;
+		std::size_t uv_matching = 0u;
+		std::size_t normal_missing = 0u;
+		std::size_t normal_matching = 0u;
+	};
+
+	static void parse_obj_chunk(const char* p, const char* end, ObjChunk& chunk, const std::string& path)
+	{
+		std::vector<ObjCorner> polygon;
+
+		auto fail = [&](const char* line, const char* line_end) {
+			Util::throw_exception("Malformed OBJ line: " + std::string(line, line_end), path.c_str());
+		};
+
+		// 1-based OBJ index to the 0-based or chunk-relative form described by ObjCorner
+		auto convert = [](std::int64_t index, std::size_t count) {
+			return index > 0 ? index - 1 : static_cast<std::int64_t>(count) + index - OBJ_RELATIVE_BIAS;
+		};
+
+		while (p != end) {
+			const char* line = skip_spaces(p, end);
+			const char* line_end = static_cast<const char*>(std::memchr(line, '\n', static_cast<std::size_t>(end - line)));
+			if (line_end == nullptr) {
+				line_end = end;
+			}
+			p = line_end == end ? end : line_end + 1;
+
+			// Statements without geometry, such as o, g, s, usemtl or comments, are skipped
+			std::ptrdiff_t length = line_end - line;
+			if (length >= 2 && line[0] == 'v') {
+				int component_count = 3;
+				const char* q = line + 1;
+				if (length >= 3 && (line[1] == 't' || line[1] == 'n') && is_space(line[2])) {
+					component_count = line[1] == 't' ? 2 : 3;
+					q = line + 2;
+				} else if (!is_space(line[1])) {
+					continue;
+				}
+
+				// Extra values, such as vertex colours after a position, are ignored
+				float values[3] = {};
+				for (int i = 0; i < component_count; ++i) {
+					q = skip_spaces(q, line_end);
+					const char* next = MeshImporter::parse_float(q, line_end, values[i]);
+					if (next == q) {
+						// The second texture coordinate is optional
+						if (component_count == 2 && i == 1) {
+							break;
+						}
+						fail(line, line_end);
+					}
+					q = next;
+				}
+
+				if (line[1] == 't') {
+					chunk.uvs.emplace_back(values[0], values[1]);
+				} else if (line[1] == 'n') {
+					chunk.normals.emplace_back(values[0], values[1], values[2]);
+				} else {
+					chunk.positions.emplace_back(values[0], values[1], values[2]);
+				}
+			} else if (length >= 2 && line[0] == 'f' && is_space(line[1])) {
+				polygon.clear();
+				const char* q = skip_spaces(line + 1, line_end);
+				while (q != line_end) {
+					std::int64_t values[3] = { 0, 0, 0 };
+					for (int i = 0; i < 3; ++i) {
+						if (i > 0) {
+							if (q == line_end || *q != '/') {
+								break;
+							}
+							++q;
+							if (q != line_end && *q == '/') {
+								continue;
+							}
+						}
+						const char* next = parse_integer(q, line_end, values[i]);
+						if (next == q && i != 1) {
+							fail(line, line_end);
+						}
+						q = next;
+					}
+					if (values[0] == 0 || (q != line_end && !is_space(*q))) {
+						fail(line, line_end);
+					}
+
+					polygon.push_back(ObjCorner{
+						convert(values[0], chunk.positions.size()),
+						values[1] != 0 ? convert(values[1], chunk.uvs.size()) : OBJ_NONE,
+						values[2] != 0 ? convert(values[2], chunk.normals.size()) : OBJ_NONE,
+					});
+					q = skip_spaces(q, line_end);
+				}
+
+				if (polygon.size() < 3u) {
+					fail(line, line_end);
+				}
+				for (std::size_t i = 2u; i < polygon.size(); ++i) {
+					chunk.corners.insert(chunk.corners.end(), { polygon[0], polygon[i - 1u], polygon[i] });
+				}
+			}
+		}
+	}
+
+	/// Copy one attribute of every chunk into a single array, each chunk in parallel.
+	template<typename Source, typename Target>
+	static void gather_obj_chunks(ThreadPool& threads, const std::vector<ObjChunk>& chunks, std::vector<Source> ObjChunk::* member,
+		const std::vector<std::size_t>& offsets, Target* target)
+	{
+		threads.parallel_for(chunks.size(), 1u, [&](std::size_t begin, std::size_t end) {
+			for (std::size_t c = begin; c < end; ++c) {
+				const std::vector<Source>& source = chunks[c].*member;
+				for (std::size_t i = 0u; i < source.size(); ++i) {
+					target[offsets[c] + i] = Target{ source[i] };
+				}
+			}
+		});
+	}
+
+	ImportedMesh MeshImporter::import_obj(const std::string& path)
+	{
+		FileView view(path, FileAccess::SEQUENTIAL);
+		const char* data = view.get_data();
+		const std::size_t size = view.get_size();
+
+		// Split at line boundaries into a few chunks per thread
+		std::size_t chunk_count = std::clamp<std::size_t>(size / OBJ_CHUNK_SIZE, 1u, threads.get_concurrency() * 4u);
+		std::vector<std::size_t> chunk_starts(chunk_count + 1u, size);
+		chunk_starts[0] = 0u;
+		for (std::size_t c = 1u; c < chunk_count; ++c) {
+			std::size_t start = std::max(size / chunk_count * c, chunk_starts[c - 1u]);
+			const void* newline = std::memchr(data + start, '\n', size - start);
+			chunk_starts[c] = newline != nullptr ? static_cast<std::size_t>(static_cast<const char*>(newline) - data) + 1u : size;
+		}
+
+		std::vector<ObjChunk> chunks(chunk_count);
+		threads.parallel_for(chunk_count, 1u, [&](std::size_t begin, std::size_t end) {
+			for (std::size_t c = begin; c < end; ++c) {
+				parse_obj_chunk(data + chunk_starts[c], data + chunk_starts[c + 1u], chunks[c], path);
+			}
+		});
+
+		// Offsets of each chunk's elements in the whole file
+		std::vector<std::size_t> position_offsets(chunk_count + 1u, 0u);
+		std::vector<std::size_t> uv_offsets(chunk_count + 1u, 0u);
+		std::vector<std::size_t> normal_offsets(chunk_count + 1u, 0u);
+		std::vector<std::size_t> corner_offsets(chunk_count + 1u, 0u);
+		for (std::size_t c = 0u; c < chunk_count; ++c) {
+			position_offsets[c + 1u] = position_offsets[c] + chunks[c].positions.size();
+			uv_offsets[c + 1u] = uv_offsets[c] + chunks[c].uvs.size();
+			normal_offsets[c + 1u] = normal_offsets[c] + chunks[c].normals.size();
+			corner_offsets[c + 1u] = corner_offsets[c] + chunks[c].corners.size();
+		}
+
+		const std::size_t position_count = position_offsets[chunk_count];
+		const std::size_t uv_count = uv_offsets[chunk_count];
+		const std::size_t normal_count = normal_offsets[chunk_count];
+		const std::size_t corner_count = corner_offsets[chunk_count];
+		if (corner_count == 0u) {
+			Util::throw_exception("OBJ file has no faces", path.c_str());
+		}
+		if (position_count > std::numeric_limits<MeshPool::Index>::max() || corner_count > std::numeric_limits<MeshPool::Index>::max()) {
+			Util::throw_exception("OBJ file is too large to index", path.c_str());
+		}
+
+		// Resolve every corner to whole-file indices, and check which corners could skip welding
+		threads.parallel_for(chunk_count, 1u, [&](std::size_t begin, std::size_t end) {
+			auto resolve = [&](std::int64_t index, std::size_t offset, std::size_t count) {
+				if (index == OBJ_NONE) {
+					return index;
+				}
+				std::int64_t resolved = index < 0 ? index + OBJ_RELATIVE_BIAS + static_cast<std::int64_t>(offset) : index;
+				if (resolved < 0 || resolved >= static_cast<std::int64_t>(count)) {
+					Util::throw_exception("OBJ face index out of range", path.c_str());
+				}
+				return resolved;
+			};
+
+			for (std::size_t c = begin; c < end; ++c) {
+				ObjChunk& chunk = chunks[c];
+				for (ObjCorner& corner : chunk.corners) {
+					corner.position = resolve(corner.position, position_offsets[c], position_count);
+					corner.uv = resolve(corner.uv, uv_offsets[c], uv_count);
+					corner.normal = resolve(corner.normal, normal_offsets[c], normal_count);
+
+					chunk.uv_missing += corner.uv == OBJ_NONE;
+					chunk.uv_matching += corner.uv == corner.position;
+					chunk.normal_missing += corner.normal == OBJ_NONE;
+					chunk.normal_matching += corner.normal == corner.position;
+				}
+			}
+		});
+
+		std::size_t uv_missing = 0u;
+		std::size_t uv_matching = 0u;
+		std::size_t normal_missing = 0u;
+		std::size_t normal_matching = 0u;
+		for (const ObjChunk& chunk : chunks) {
+			uv_missing += chunk.uv_missing;
+			uv_matching += chunk.uv_matching;
+			normal_missing += chunk.normal_missing;
+			normal_matching += chunk.normal_matching;
+		}
+
+		ImportedMesh imported;
+		IndexedMesh& mesh = imported.mesh;
+
+		// Scans and most exporters write one UV and normal per position, so positions can be used as vertices
+		// directly. Anything else needs each unique corner made into its own vertex.
+		bool uv_direct = uv_missing == corner_count || (uv_matching == corner_count && uv_count == position_count);
+		bool normal_direct = normal_missing == corner_count || (normal_matching == corner_count && normal_count == position_count);
+		if (uv_direct && normal_direct) {
+			mesh.vertices.resize(position_count);
+			gather_obj_chunks(threads, chunks, &ObjChunk::positions, position_offsets, mesh.vertices.data());
+			if (uv_missing == 0u) {
+				imported.uvs.resize(uv_count);
+				gather_obj_chunks(threads, chunks, &ObjChunk::uvs, uv_offsets, imported.uvs.data());
+			}
+			if (normal_missing == 0u) {
+				imported.normals.resize(normal_count);
+				gather_obj_chunks(threads, chunks, &ObjChunk::normals, normal_offsets, imported.normals.data());
+			}
+
+			mesh.indices.resize(corner_count);
+			threads.parallel_for(chunk_count, 1u, [&](std::size_t begin, std::size_t end) {
+				for (std::size_t c = begin; c < end; ++c) {
+					MeshPool::Index* target = mesh.indices.data() + corner_offsets[c];
+					for (const ObjCorner& corner : chunks[c].corners) {
+						*target++ = static_cast<MeshPool::Index>(corner.position);
+					}
+				}
+			});
+			return imported;
+		}
+
+		std::vector<glm::vec3> positions(position_count);
+		std::vector<glm::vec2> uvs(uv_count);
+		std::vector<glm::vec3> normals(normal_count);
+		gather_obj_chunks(threads, chunks, &ObjChunk::positions, position_offsets, positions.data());
+		gather_obj_chunks(threads, chunks, &ObjChunk::uvs, uv_offsets, uvs.data());
+		gather_obj_chunks(threads, chunks, &ObjChunk::normals, normal_offsets, normals.data());
+
+		// Welding assigns vertex numbers in order of first use, so it stays on one thread
+		bool has_uvs = uv_missing != corner_count;
+		bool has_normals = normal_missing != corner_count;
+		auto hash = [](const ObjCorner& corner) {
+			std::uint64_t value = static_cast<std::uint64_t>(corner.position) * 0x9E3779B97F4A7C15ull;
+			value = (value ^ static_cast<std::uint64_t>(corner.uv)) * 0xBF58476D1CE4E5B9ull;
+			value = (value ^ static_cast<std::uint64_t>(corner.normal)) * 0x94D049BB133111EBull;
+			return static_cast<std::size_t>(value ^ (value >> 31u));
+		};
+		auto equal = [](const ObjCorner& a, const ObjCorner& b) {
+			return a.position == b.position && a.uv == b.uv && a.normal == b.normal;
+		};
+		std::unordered_map<ObjCorner, MeshPool::Index, decltype(hash), decltype(equal)> unique(position_count, hash, equal);
+
+		mesh.vertices.reserve(position_count);
+		mesh.indices.reserve(corner_count);
+		for (const ObjChunk& chunk : chunks) {
+			for (const ObjCorner& corner : chunk.corners) {
+				auto [it, inserted] = unique.emplace(corner, static_cast<MeshPool::Index>(mesh.vertices.size()));
+				if (inserted) {
+					mesh.vertices.push_back(MeshPool::Vertex{ positions[corner.position] });
+					if (has_uvs) {
+						imported.uvs.push_back(corner.uv != OBJ_NONE ? uvs[corner.uv] : glm::vec2{ 0.0f });
+					}
+					if (has_normals) {
+						imported.normals.push_back(corner.normal != OBJ_NONE ? normals[corner.normal] : glm::vec3{ 0.0f });
+					}
+				}
+				mesh.indices.push_back(it->second);
+			}
+		}
+		return imported;
+	}
+
+	// ---- glTF 2.0
+
+	/// Just enough JSON for a glTF document. The document is small next to its buffers, so a plain tree will do.
+	struct JsonValue {
+		enum class Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+		Type type = Type::NUL;
+		bool boolean = false;
+		double number = 0.0;
+		std::string string{};
+		/// Array elements, or object member values.
+		std::vector<JsonValue> elements{};
+		/// Object member names, matching elements.
+		std::vector<std::string> keys{};
+
+		[[nodiscard]] const JsonValue* find(const char* key) const noexcept
+		{
+			for (std::size_t i = 0u; i < keys.size(); ++i) {
+				if (keys[i] == key) {
+					return &elements[i];
+				}
+			}
+			return nullptr;
+		}
+
+		[[nodiscard]] double get_number(const char* key, double fallback) const noexcept
+		{
+			const JsonValue* value = find(key);
+			return value != nullptr && value->type == Type::NUMBER ? value->number : fallback;
+		}
+
+		[[nodiscard]] const std::vector<JsonValue>& get_array(const char* key) const noexcept
+		{
+			static const std::vector<JsonValue> EMPTY{};
+			const JsonValue* value = find(key);
+			return value != nullptr && value->type == Type::ARRAY ? value->elements : EMPTY;
+		}
+	};
+
+	struct JsonParser {
+		const char* p;
+		const char* end;
+		const std::string& path;
+
+		[[noreturn]] void fail() const
+		{
+			throw std::runtime_error("Malformed glTF JSON\n" + path);
+		}
+
+		void skip_whitespace() noexcept
+		{
+			while (p != end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+				++p;
+			}
+		}
+
+		void expect(char c)
+		{
+			skip_whitespace();
+			if (p == end || *p != c) {
+				fail();
+			}
+			++p;
+		}
+
+		JsonValue parse_value(int depth)
+		{
+			if (depth > 128) {
+				fail();
+			}
+
+			skip_whitespace();
+			if (p == end) {
+				fail();
+			}
+
+			JsonValue value;
+			auto literal = [&](const char* text) {
+				std::size_t length = std::strlen(text);
+				if (static_cast<std::size_t>(end - p) < length || std::memcmp(p, text, length) != 0) {
+					fail();
+				}
+				p += length;
+			};
+
+			switch (*p) {
+				case '{':
+					value.type = JsonValue::Type::OBJECT;
+					++p;
+					skip_whitespace();
+					if (p != end && *p == '}') {
+						++p;
+						break;
+					}
+					while (true) {
+						skip_whitespace();
+						value.keys.push_back(parse_string());
+						expect(':');
+						value.elements.push_back(parse_value(depth + 1));
+						skip_whitespace();
+						if (p == end || *p != ',') {
+							break;
+						}
+						++p;
+					}
+					expect('}');
+					break;
+				case '[':
+					value.type = JsonValue::Type::ARRAY;
+					++p;
+					skip_whitespace();
+					if (p != end && *p == ']') {
+						++p;
+						break;
+					}
+					while (true) {
+						value.elements.push_back(parse_value(depth + 1));
+						skip_whitespace();
+						if (p == end || *p != ',') {
+							break;
+						}
+						++p;
+					}
+					expect(']');
+					break;
+				case '"':
+					value.type = JsonValue::Type::STRING;
+					value.string = parse_string();
+					break;
+				case 't':
+					literal("true");
+					value.type = JsonValue::Type::BOOLEAN;
+					value.boolean = true;
+					break;
+				case 'f':
+					literal("false");
+					value.type = JsonValue::Type::BOOLEAN;
+					break;
+				case 'n':
+					literal("null");
+					break;
+				default: {
+					// The document is held in a std::string, so strtod always finds a terminator
+					char* number_end = nullptr;
+					value.type = JsonValue::Type::NUMBER;
+					value.number = std::strtod(p, &number_end);
+					if (number_end == p) {
+						fail();
+					}
+					p = number_end;
+					break;
+				}
+			}
+			return value;
+		}
+
+		std::string parse_string()
+		{
+			if (p == end || *p != '"') {
+				fail();
+			}
+			++p;
+
+			std::string text;
+			while (p != end && *p != '"') {
+				char c = *p++;
+				if (c != '\\') {
+					text += c;
+					continue;
+				}
+				if (p == end) {
+					fail();
+				}
+
+				switch (char escape = *p++) {
+					case 'b': text += '\b'; break;
+					case 'f': text += '\f'; break;
+					case 'n': text += '\n'; break;
+					case 'r': text += '\r'; break;
+					case 't': text += '\t'; break;
+					case 'u': {
+						std::uint32_t code = parse_code_unit();
+						if (code >= 0xD800u && code < 0xDC00u && end - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+							p += 2;
+							code = 0x10000u + ((code - 0xD800u) << 10u) + (parse_code_unit() - 0xDC00u);
+						}
+						append_utf8(text, code);
+						break;
+					}
+					default:
+						text += escape;
+						break;
+				}
+			}
+			if (p == end) {
+				fail();
+			}
+			++p;
+			return text;
+		}
+
+		std::uint32_t parse_code_unit()
+		{
+			if (end - p < 4) {
+				fail();
+			}
+			std::uint32_t code = 0u;
+			for (int i = 0; i < 4; ++i) {
+				char c = *p++;
+				code <<= 4u;
+				if (is_digit(c)) {
+					code |= static_cast<std::uint32_t>(c - '0');
+				} else if (c >= 'a' && c <= 'f') {
+					code |= static_cast<std::uint32_t>(c - 'a' + 10);
+				} else if (c >= 'A' && c <= 'F') {
+					code |= static_cast<std::uint32_t>(c - 'A' + 10);
+				} else {
+					fail();
+				}
+			}
+			return code;
+		}
+
+		static void append_utf8(std::string& text, std::uint32_t code)
+		{
+			if (code < 0x80u) {
+				text += static_cast<char>(code);
+			} else if (code < 0x800u) {
+				text += static_cast<char>(0xC0u | (code >> 6u));
+				text += static_cast<char>(0x80u | (code & 0x3Fu));
+			} else if (code < 0x10000u) {
+				text += static_cast<char>(0xE0u | (code >> 12u));
+				text += static_cast<char>(0x80u | ((code >> 6u) & 0x3Fu));
+				text += static_cast<char>(0x80u | (code & 0x3Fu));
+			} else {
+				text += static_cast<char>(0xF0u | (code >> 18u));
+				text += static_cast<char>(0x80u | ((code >> 12u) & 0x3Fu));
+				text += static_cast<char>(0x80u | ((code >> 6u) & 0x3Fu));
+				text += static_cast<char>(0x80u | (code & 0x3Fu));
+			}
+		}
+	};
+
+	/// Component types from the glTF specification, which reuses the GL enums.
+	struct GltfComponent {
+		enum : std::uint32_t {
+			BYTE = 5120,
+			UNSIGNED_BYTE = 5121,
+			SHORT = 5122,
+			UNSIGNED_SHORT = 5123,
+			UNSIGNED_INT = 5125,
+			FLOAT = 5126,
+		};
+	};
+
+	/// Bytes of a buffer, either in a mapped file or decoded from a data URI.
+	struct GltfBuffer {
+		const unsigned char* data = nullptr;
+		std::size_t size = 0u;
+	};
+
+	/// Strided elements of one accessor, checked to lie inside their buffer.
+	struct GltfAccessor {
+		const unsigned char* data = nullptr;
+		std::size_t count = 0u;
+		std::size_t stride = 0u;
+		std::uint32_t component_type = 0u;
+		std::uint32_t components = 0u;
+		bool normalized = false;
+
+		[[nodiscard]] float read(std::size_t element, std::uint32_t component) const noexcept
+		{
+			const unsigned char* source = data + element * stride;
+			switch (component_type) {
+				case GltfComponent::BYTE: {
+					std::int8_t value;
+					std::memcpy(&value, source + component, sizeof(value));
+					return normalized ? std::max(value / 127.0f, -1.0f) : static_cast<float>(value);
+				}
+				case GltfComponent::UNSIGNED_BYTE: {
+					std::uint8_t value = source[component];
+					return normalized ? value / 255.0f : static_cast<float>(value);
+				}
+				case GltfComponent::SHORT: {
+					std::int16_t value;
+					std::memcpy(&value, source + component * sizeof(value), sizeof(value));
+					return normalized ? std::max(value / 32767.0f, -1.0f) : static_cast<float>(value);
+				}
+				case GltfComponent::UNSIGNED_SHORT: {
+					std::uint16_t value;
+					std::memcpy(&value, source + component * sizeof(value), sizeof(value));
+					return normalized ? value / 65535.0f : static_cast<float>(value);
+				}
+				case GltfComponent::UNSIGNED_INT: {
+					std::uint32_t value;
+					std::memcpy(&value, source + component * sizeof(value), sizeof(value));
+					return static_cast<float>(value);
+				}
+				default: {
+					float value;
+					std::memcpy(&value, source + component * sizeof(value), sizeof(value));
+					return value;
+				}
+			}
+		}
+
+		[[nodiscard]] std::uint32_t read_index(std::size_t element) const noexcept
+		{
+			const unsigned char* source = data + element * stride;
+			switch (component_type) {
+				case GltfComponent::UNSIGNED_BYTE:
+					return source[0];
+				case GltfComponent::UNSIGNED_SHORT: {
+					std::uint16_t value;
+					std::memcpy(&value, source, sizeof(value));
+					return value;
+				}
+				default: {
+					std::uint32_t value;
+					std::memcpy(&value, source, sizeof(value));
+					return value;
+				}
+			}
+		}
+	};
+
+	/// One triangle primitive placed in the scene, and where its vertices and indices go in the output.
+	struct GltfPrimitive {
+		GltfAccessor positions{};
+		GltfAccessor normals{};
+		GltfAccessor uvs{};
+		GltfAccessor indices{};
+		glm::mat4 transform{ 1.0f };
+		glm::mat3 normal_transform{ 1.0f };
+		/// Mirroring transforms turn triangles inside out unless their winding is flipped back.
+		bool flip_winding = false;
+		std::size_t first_vertex = 0u;
+		std::size_t first_index = 0u;
+
+		[[nodiscard]] std::size_t get_index_count() const noexcept { return indices.data != nullptr ? indices.count : positions.count; }
+	};
+
+	/// A range of one primitive's vertices or indices to convert.
+	struct GltfTask {
+		std::size_t primitive;
+		bool indices;
+		std::size_t begin;
+		std::size_t end;
+	};
+
+	static std::vector<unsigned char> decode_base64(const char* p, const char* end, const std::string& path)
+	{
+		auto sextet = [](char c) -> int {
+			if (c >= 'A' && c <= 'Z') return c - 'A';
+			if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+			if (is_digit(c)) return c - '0' + 52;
+			if (c == '+' || c == '-') return 62;
+			if (c == '/' || c == '_') return 63;
+			return -1;
+		};
+
+		std::vector<unsigned char> bytes;
+		bytes.reserve(static_cast<std::size_t>(end - p) / 4u * 3u);
+		std::uint32_t bits = 0u;
+		int bit_count = 0;
+		for (; p != end && *p != '='; ++p) {
+			int value = sextet(*p);
+			if (value < 0) {
+				Util::throw_exception("Invalid base64 data in glTF buffer", path.c_str());
+			}
+			bits = (bits << 6u) | static_cast<std::uint32_t>(value);
+			bit_count += 6;
+			if (bit_count >= 8) {
+				bit_count -= 8;
+				bytes.push_back(static_cast<unsigned char>(bits >> bit_count));
+			}
+		}
+		return bytes;
+	}
+
+	/// URIs in glTF are percent-encoded and relative to the document.
+	static std::string resolve_uri(const std::string& uri, const std::string& path)
+	{
+		std::string decoded;
+		for (std::size_t i = 0u; i < uri.size(); ++i) {
+			if (uri[i] == '%' && i + 2u < uri.size()) {
+				decoded += static_cast<char>(std::strtol(uri.substr(i + 1u, 2u).c_str(), nullptr, 16));
+				i += 2u;
+			} else {
+				decoded += uri[i];
+			}
+		}
+
+		std::size_t separator = path.find_last_of("/\\");
+		return separator == std::string::npos ? decoded : path.substr(0u, separator + 1u) + decoded;
+	}
+
+	static glm::mat4 get_node_transform(const JsonValue& node)
+	{
+		const std::vector<JsonValue>& matrix = node.get_array("matrix");
+		if (matrix.size() == 16u) {
+			glm::mat4 transform;
+			for (std::size_t i = 0u; i < 16u; ++i) {
+				glm::value_ptr(transform)[i] = static_cast<float>(matrix[i].number);
+			}
+			return transform;
+		}
+
+		auto read = [&](const char* key, std::size_t count, float* values) {
+			const std::vector<JsonValue>& array = node.get_array(key);
+			if (array.size() == count) {
+				for (std::size_t i = 0u; i < count; ++i) {
+					values[i] = static_cast<float>(array[i].number);
+				}
+			}
+		};
+
+		glm::vec3 translation{ 0.0f };
+		glm::vec4 rotation{ 0.0f, 0.0f, 0.0f, 1.0f };
+		glm::vec3 scale{ 1.0f };
+		read("translation", 3u, glm::value_ptr(translation));
+		read("rotation", 4u, glm::value_ptr(rotation));
+		read("scale", 3u, glm::value_ptr(scale));
+
+		glm::quat orientation{ rotation.w, rotation.x, rotation.y, rotation.z };
+		return glm::scale(glm::translate(glm::mat4{ 1.0f }, translation) * glm::mat4_cast(orientation), scale);
+	}
+
+	ImportedMesh MeshImporter::import_gltf(const std::string& path)
+	{
+		FileView view(path, FileAccess::WILL_NEED);
+		const unsigned char* file = reinterpret_cast<const unsigned char*>(view.get_data());
+		const std::size_t file_size = view.get_size();
+
+		auto read_u32 = [&](std::size_t offset) {
+			std::uint32_t value;
+			std::memcpy(&value, file + offset, sizeof(value));
+			return value;
+		};
+
+		// Binary glTF is a JSON chunk followed by an optional chunk holding the first buffer
+		std::string json;
+		GltfBuffer binary_chunk;
+		static constexpr std::uint32_t GLB_MAGIC = 0x46546C67u;
+		static constexpr std::uint32_t GLB_JSON = 0x4E4F534Au;
+		static constexpr std::uint32_t GLB_BIN = 0x004E4942u;
+		if (file_size >= 12u && read_u32(0u) == GLB_MAGIC) {
+			if (read_u32(4u) != 2u) {
+				Util::throw_exception("Unsupported glTF version", path.c_str());
+			}
+			std::size_t offset = 12u;
+			while (offset + 8u <= file_size) {
+				std::size_t length = read_u32(offset);
+				std::uint32_t type = read_u32(offset + 4u);
+				offset += 8u;
+				if (length > file_size - offset) {
+					Util::throw_exception("Truncated chunk in binary glTF", path.c_str());
+				}
+				if (type == GLB_JSON && json.empty()) {
+					json.assign(reinterpret_cast<const char*>(file + offset), length);
+				} else if (type == GLB_BIN && binary_chunk.data == nullptr) {
+					binary_chunk = GltfBuffer{ file + offset, length };
+				}
+				offset += (length + 3u) & ~std::size_t{ 3u };
+			}
+		} else {
+			json.assign(reinterpret_cast<const char*>(file), file_size);
+		}
+
+		JsonParser parser{ json.data(), json.data() + json.size(), path };
+		JsonValue document = parser.parse_value(0);
+		parser.skip_whitespace();
+		if (parser.p != parser.end || document.type != JsonValue::Type::OBJECT) {
+			parser.fail();
+		}
+
+		const JsonValue* asset = document.find("asset");
+		if (asset == nullptr || asset->find("version") == nullptr || asset->find("version")->string.rfind("2.", 0u) != 0u) {
+			Util::throw_exception("Unsupported glTF version", path.c_str());
+		}
+
+		// Every index in the document is checked before use
+		auto get_index = [&](const JsonValue& object, const char* key, std::size_t count) {
+			double value = object.get_number(key, -1.0);
+			if (value < 0.0 || value >= static_cast<double>(count) || value != std::floor(value)) {
+				Util::throw_exception(std::string("Missing or invalid glTF index: ") + key, path.c_str());
+			}
+			return static_cast<std::size_t>(value);
+		};
+
+		// Sizes and offsets likewise, so that converting them is defined and the bounds checks below cannot overflow
+		auto get_size = [&](const JsonValue& object, const char* key, std::size_t fallback) {
+			const JsonValue* value = object.find(key);
+			if (value == nullptr) {
+				return fallback;
+			}
+			if (value->type != JsonValue::Type::NUMBER || value->number < 0.0 || value->number != std::floor(value->number)
+				|| value->number > static_cast<double>(std::numeric_limits<std::uint32_t>::max())) {
+				Util::throw_exception(std::string("Invalid glTF size: ") + key, path.c_str());
+			}
+			return static_cast<std::size_t>(value->number);
+		};
+
+		std::vector<GltfBuffer> buffers;
+		std::vector<FileView> external_files;
+		std::vector<std::vector<unsigned char>> decoded_buffers;
+		const std::vector<JsonValue>& buffer_list = document.get_array("buffers");
+		external_files.reserve(buffer_list.size());
+		decoded_buffers.reserve(buffer_list.size());
+		for (const JsonValue& buffer : buffer_list) {
+			std::size_t length = get_size(buffer, "byteLength", 0u);
+			const JsonValue* uri = buffer.find("uri");
+
+			GltfBuffer contents;
+			if (uri == nullptr) {
+				contents = binary_chunk;
+			} else if (uri->string.rfind("data:", 0u) == 0u) {
+				std::size_t start = uri->string.find(";base64,");
+				if (start == std::string::npos) {
+					Util::throw_exception("Unsupported data URI in glTF buffer", path.c_str());
+				}
+				start += std::strlen(";base64,");
+				decoded_buffers.push_back(decode_base64(uri->string.data() + start, uri->string.data() + uri->string.size(), path));
+				contents = GltfBuffer{ decoded_buffers.back().data(), decoded_buffers.back().size() };
+			} else {
+				external_files.emplace_back(resolve_uri(uri->string, path), FileAccess::WILL_NEED);
+				contents = GltfBuffer{ reinterpret_cast<const unsigned char*>(external_files.back().get_data()), external_files.back().get_size() };
+			}
+
+			if (contents.size < length) {
+				Util::throw_exception("glTF buffer is shorter than its byteLength", path.c_str());
+			}
+			buffers.push_back(GltfBuffer{ contents.data, length });
+		}
+
+		const std::vector<JsonValue>& buffer_views = document.get_array("bufferViews");
+		const std::vector<JsonValue>& accessors = document.get_array("accessors");
+		auto get_accessor = [&](std::size_t index) {
+			const JsonValue& accessor = accessors[index];
+			if (accessor.find("sparse") != nullptr) {
+				Util::throw_exception("Sparse glTF accessors are not supported", path.c_str());
+			}
+
+			const JsonValue& buffer_view = buffer_views[get_index(accessor, "bufferView", buffer_views.size())];
+			const GltfBuffer& buffer = buffers[get_index(buffer_view, "buffer", buffers.size())];
+			std::uint64_t view_offset = get_size(buffer_view, "byteOffset", 0u);
+			std::uint64_t view_length = get_size(buffer_view, "byteLength", 0u);
+
+			GltfAccessor result;
+			result.component_type = static_cast<std::uint32_t>(get_size(accessor, "componentType", 0u));
+			result.normalized = accessor.find("normalized") != nullptr && accessor.find("normalized")->boolean;
+			result.count = get_size(accessor, "count", 0u);
+
+			const JsonValue* type = accessor.find("type");
+			static constexpr const char* TYPES[] = { "SCALAR", "VEC2", "VEC3", "VEC4" };
+			for (std::uint32_t i = 0u; type != nullptr && i < 4u; ++i) {
+				if (type->string == TYPES[i]) {
+					result.components = i + 1u;
+				}
+			}
+
+			std::size_t component_size = 0u;
+			switch (result.component_type) {
+				case GltfComponent::BYTE:
+				case GltfComponent::UNSIGNED_BYTE:
+					component_size = 1u;
+					break;
+				case GltfComponent::SHORT:
+				case GltfComponent::UNSIGNED_SHORT:
+					component_size = 2u;
+					break;
+				case GltfComponent::UNSIGNED_INT:
+				case GltfComponent::FLOAT:
+					component_size = 4u;
+					break;
+			}
+			if (component_size == 0u || result.components == 0u) {
+				Util::throw_exception("Unsupported glTF accessor type", path.c_str());
+			}
+
+			std::size_t element_size = component_size * result.components;
+			// Every term is below 2^32, so 64-bit arithmetic cannot overflow even where size_t is 32 bits
+			std::uint64_t offset = view_offset + get_size(accessor, "byteOffset", 0u);
+			result.stride = get_size(buffer_view, "byteStride", element_size);
+			if (view_offset > buffer.size || view_length > buffer.size - view_offset || result.stride < element_size
+				|| (result.count > 0u && (offset > view_offset + view_length
+					|| std::uint64_t{ result.count - 1u } * result.stride + element_size > view_offset + view_length - offset))) {
+				Util::throw_exception("glTF accessor lies outside its buffer", path.c_str());
+			}
+			result.data = buffer.data + static_cast<std::size_t>(offset);
+			return result;
+		};
+
+		// Place every mesh instance in the scene, or every mesh once if there is no scene
+		struct GltfDraw {
+			std::size_t mesh;
+			glm::mat4 transform;
+		};
+		std::vector<GltfDraw> draws;
+		const std::vector<JsonValue>& meshes = document.get_array("meshes");
+		const std::vector<JsonValue>& nodes = document.get_array("nodes");
+		const std::vector<JsonValue>& scenes = document.get_array("scenes");
+		if (scenes.empty()) {
+			for (std::size_t i = 0u; i < meshes.size(); ++i) {
+				draws.push_back(GltfDraw{ i, glm::mat4{ 1.0f } });
+			}
+		} else {
+			std::size_t scene = document.find("scene") != nullptr ? get_index(document, "scene", scenes.size()) : 0u;
+
+			// Explicit stack; the depth limit stops cycles in malformed files
+			struct PendingNode {
+				std::size_t node;
+				glm::mat4 parent;
+				std::size_t depth;
+			};
+			std::vector<PendingNode> pending;
+			for (const JsonValue& root : scenes[scene].get_array("nodes")) {
+				if (root.number < 0.0 || root.number >= static_cast<double>(nodes.size())) {
+					Util::throw_exception("Missing or invalid glTF index: nodes", path.c_str());
+				}
+				pending.push_back(PendingNode{ static_cast<std::size_t>(root.number), glm::mat4{ 1.0f }, 0u });
+			}
+			while (!pending.empty()) {
+				PendingNode current = pending.back();
+				pending.pop_back();
+				if (current.depth > nodes.size()) {
+					Util::throw_exception("glTF node hierarchy has a cycle", path.c_str());
+				}
+
+				const JsonValue& node = nodes[current.node];
+				glm::mat4 transform = current.parent * get_node_transform(node);
+				if (node.find("mesh") != nullptr) {
+					draws.push_back(GltfDraw{ get_index(node, "mesh", meshes.size()), transform });
+				}
+				for (const JsonValue& child : node.get_array("children")) {
+					if (child.number < 0.0 || child.number >= static_cast<double>(nodes.size())) {
+						Util::throw_exception("Missing or invalid glTF index: children", path.c_str());
+					}
+					pending.push_back(PendingNode{ static_cast<std::size_t>(child.number), transform, current.depth + 1u });
+				}
+			}
+		}
+
+		// Lay out every triangle primitive back to back in the output
+		static constexpr double TRIANGLES = 4.0;
+		std::vector<GltfPrimitive> primitives;
+		std::size_t vertex_count = 0u;
+		std::size_t index_count = 0u;
+		bool has_normals = false;
+		bool has_uvs = false;
+		for (const GltfDraw& draw : draws) {
+			for (const JsonValue& source : meshes[draw.mesh].get_array("primitives")) {
+				const JsonValue* attributes = source.find("attributes");
+				if (source.get_number("mode", TRIANGLES) != TRIANGLES || attributes == nullptr || attributes->find("POSITION") == nullptr) {
+					continue;
+				}
+
+				GltfPrimitive primitive;
+				primitive.positions = get_accessor(get_index(*attributes, "POSITION", accessors.size()));
+				if (attributes->find("NORMAL") != nullptr) {
+					primitive.normals = get_accessor(get_index(*attributes, "NORMAL", accessors.size()));
+				}
+				if (attributes->find("TEXCOORD_0") != nullptr) {
+					primitive.uvs = get_accessor(get_index(*attributes, "TEXCOORD_0", accessors.size()));
+				}
+				if (source.find("indices") != nullptr) {
+					primitive.indices = get_accessor(get_index(source, "indices", accessors.size()));
+					if (primitive.indices.components != 1u || primitive.indices.component_type == GltfComponent::BYTE
+						|| primitive.indices.component_type == GltfComponent::SHORT || primitive.indices.component_type == GltfComponent::FLOAT) {
+						Util::throw_exception("Invalid glTF index accessor", path.c_str());
+					}
+				}
+
+				if (primitive.positions.components < 3u || (primitive.normals.data != nullptr && primitive.normals.components < 3u)
+					|| (primitive.uvs.data != nullptr && primitive.uvs.components < 2u)
+					|| (primitive.normals.data != nullptr && primitive.normals.count != primitive.positions.count)
+					|| (primitive.uvs.data != nullptr && primitive.uvs.count != primitive.positions.count)) {
+					Util::throw_exception("Invalid glTF vertex attributes", path.c_str());
+				}
+				if (primitive.get_index_count() % 3u != 0u) {
+					Util::throw_exception("glTF triangle primitive has a partial triangle", path.c_str());
+				}
+
+				primitive.transform = draw.transform;
+				primitive.normal_transform = glm::transpose(glm::inverse(glm::mat3{ draw.transform }));
+				primitive.flip_winding = glm::determinant(glm::mat3{ draw.transform }) < 0.0f;
+				primitive.first_vertex = vertex_count;
+				primitive.first_index = index_count;
+				vertex_count += primitive.positions.count;
+				index_count += primitive.get_index_count();
+				has_normals |= primitive.normals.data != nullptr;
+				has_uvs |= primitive.uvs.data != nullptr;
+				primitives.push_back(primitive);
+			}
+		}
+
+		if (index_count == 0u) {
+			Util::throw_exception("glTF file has no triangles", path.c_str());
+		}
+		if (vertex_count > std::numeric_limits<MeshPool::Index>::max()) {
+			Util::throw_exception("glTF file is too large to index", path.c_str());
+		}
+
+		ImportedMesh imported;
+		imported.mesh.vertices.resize(vertex_count);
+		imported.mesh.indices.resize(index_count);
+		imported.normals.resize(has_normals ? vertex_count : 0u);
+		imported.uvs.resize(has_uvs ? vertex_count : 0u);
+
+		// Large primitives are split so one big mesh still spreads across every thread
+		std::vector<GltfTask> tasks;
+		for (std::size_t i = 0u; i < primitives.size(); ++i) {
+			for (std::size_t begin = 0u; begin < primitives[i].positions.count; begin += GLTF_RANGE_SIZE) {
+				tasks.push_back(GltfTask{ i, false, begin, std::min(begin + GLTF_RANGE_SIZE, primitives[i].positions.count) });
+			}
+			for (std::size_t begin = 0u; begin < primitives[i].get_index_count(); begin += GLTF_RANGE_SIZE) {
+				tasks.push_back(GltfTask{ i, true, begin, std::min(begin + GLTF_RANGE_SIZE, primitives[i].get_index_count()) });
+			}
+		}
+
+		threads.parallel_for(tasks.size(), 1u, [&](std::size_t begin, std::size_t end) {
+			for (std::size_t t = begin; t < end; ++t) {
+				const GltfTask& task = tasks[t];
+				const GltfPrimitive& primitive = primitives[task.primitive];
+
+				if (task.indices) {
+					MeshPool::Index* target = imported.mesh.indices.data() + primitive.first_index + task.begin;
+					for (std::size_t i = task.begin; i < task.end; ++i) {
+						std::uint32_t index = primitive.indices.data != nullptr ? primitive.indices.read_index(i) : static_cast<std::uint32_t>(i);
+						if (index >= primitive.positions.count) {
+							Util::throw_exception("glTF index out of range", path.c_str());
+						}
+						*target++ = static_cast<MeshPool::Index>(primitive.first_vertex + index);
+					}
+					if (primitive.flip_winding) {
+						for (MeshPool::Index* triangle = target - (task.end - task.begin); triangle != target; triangle += 3) {
+							std::swap(triangle[1], triangle[2]);
+						}
+					}
+					continue;
+				}
+
+				for (std::size_t i = task.begin; i < task.end; ++i) {
+					std::size_t vertex = primitive.first_vertex + i;
+					glm::vec4 position{ primitive.positions.read(i, 0u), primitive.positions.read(i, 1u), primitive.positions.read(i, 2u), 1.0f };
+					imported.mesh.vertices[vertex].position = glm::vec3{ primitive.transform * position };
+
+					if (primitive.normals.data != nullptr) {
+						glm::vec3 normal = primitive.normal_transform * glm::vec3{ primitive.normals.read(i, 0u), primitive.normals.read(i, 1u), primitive.normals.read(i, 2u) };
+						float length = glm::length(normal);
+						imported.normals[vertex] = length > 0.0f ? normal / length : normal;
+					} else if (has_normals) {
+						imported.normals[vertex] = glm::vec3{ 0.0f };
+					}
+
+					if (primitive.uvs.data != nullptr) {
+						imported.uvs[vertex] = glm::vec2{ primitive.uvs.read(i, 0u), primitive.uvs.read(i, 1u) };
+					} else if (has_uvs) {
+						imported.uvs[vertex] = glm::vec2{ 0.0f };
+					}
+				}
+			}
+		});
+
+		return imported;
+	}
+
+} // namespace coral
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "MeshUtil.h"
+#include "ThreadPool.h"
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <string>
+#include <vector>
+
+namespace coral {
+
+	/// Geometry read from a model file, ready for a MeshPool::Vertex pool as is or for MeshUtil::pack.
+	struct ImportedMesh {
+		IndexedMesh mesh{};
+		/// One per vertex, or empty if the source has none.
+		std::vector<glm::vec3> normals{};
+		/// One per vertex, or empty if the source has none.
+		std::vector<glm::vec2> uvs{};
+	};
+
+	/// Reads Wavefront OBJ and glTF 2.0 (.gltf with embedded or external buffers, and .glb) into triangle lists.
+	///
+	/// Built for throughput on large scans. Files are memory mapped, OBJ text is split at line boundaries into
+	/// chunks parsed in parallel, and glTF accessors are converted in parallel ranges. Numbers are parsed
+	/// in place without iostreams or locale lookups. Every mesh in a file is merged into one, with glTF node
+	/// transforms applied.
+	class MeshImporter {
+
+		ThreadPool threads;
+
+	public:
+
+		/// Worker threads to add to the calling thread; zero picks one per hardware thread, less the caller.
+		explicit MeshImporter(unsigned int thread_count = 0u);
+
+		/// Threads that parse a file, including the caller.
+		[[nodiscard]] std::size_t get_concurrency() const noexcept { return threads.get_concurrency(); }
+
+		/// Pick the format from the file extension. Throws on unknown extensions and malformed files.
+		[[nodiscard]] ImportedMesh import(const std::string& path);
+
+		[[nodiscard]] ImportedMesh import_obj(const std::string& path);
+		[[nodiscard]] ImportedMesh import_gltf(const std::string& path);
+
+		/// Parse a decimal float at the start of [first, last), like std::from_chars. Returns the end of the
+		/// number, or first if there is none. Accurate to within a unit in the last place for typical input.
+		static const char* parse_float(const char* first, const char* last, float& value) noexcept;
+
+	};
+
+} // namespace coral
@@ -0,0 +1,45 @@
+#include "MeshLod.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace coral {
+
+	/// Objects closer than this, or around the camera, are treated as being this far away.
+	static constexpr float MIN_DISTANCE = 1e-4f;
+
+	LodSelector::LodSelector(float pixels_per_unit, float threshold, bool is_perspective) noexcept
+		: pixels_per_unit(pixels_per_unit), threshold(threshold), is_perspective(is_perspective)
+	{
+	}
+
+	LodSelector LodSelector::perspective(float fov_y, float viewport_height, float threshold_pixels) noexcept
+	{
+		return LodSelector(viewport_height / (2.0f * std::tan(fov_y * 0.5f)), threshold_pixels, true);
+	}
+
+	LodSelector LodSelector::orthographic(float view_height, float viewport_height, float threshold_pixels) noexcept
+	{
+		return LodSelector(viewport_height / view_height, threshold_pixels, false);
+	}
+
+	float LodSelector::project(float error, float distance, float scale) const noexcept
+	{
+		float pixels = error * scale * pixels_per_unit;
+		return is_perspective ? pixels / std::max(distance, MIN_DISTANCE) : pixels;
+	}
+
+	std::size_t LodSelector::select(const LodLevel* levels, std::size_t count, float distance, float scale) const noexcept
+	{
+		// Errors grow with each level, so the first level that is too coarse ends the search
+		std::size_t selected = 0u;
+		for (std::size_t i = 1u; i < count; ++i) {
+			if (project(levels[i].error, distance, scale) > threshold) {
+				break;
+			}
+			selected = i;
+		}
+		return selected;
+	}
+
+} // namespace coral
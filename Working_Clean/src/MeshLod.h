@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace coral {
+
+	/// One level of detail: a range of a mesh's indices drawn in place of the full index list.
+	/// Levels of a mesh share its vertices and are ordered finest first.
+	struct LodLevel {
+		/// Relative to the mesh's first index.
+		std::uint32_t first_index;
+		std::uint32_t index_count;
+		/// Object-space distance by which the level may deviate from the full-detail surface. 0 for full detail.
+		float error;
+	};
+
+	/// Picks a level of detail per object from how large its geometric error would appear on screen, so that
+	/// small or distant objects draw fewer triangles without visible change. No GL calls.
+	class LodSelector {
+
+		/// Pixels covered by one unit at distance one from a perspective camera, or at any distance from an orthographic one.
+		float pixels_per_unit;
+		/// Errors larger than this many pixels are visible.
+		float threshold;
+		bool is_perspective;
+
+		LodSelector(float pixels_per_unit, float threshold, bool is_perspective) noexcept;
+
+	public:
+
+		/// Perspective camera with a vertical field of view in radians, over a viewport of the given height in pixels.
+		[[nodiscard]] static LodSelector perspective(float fov_y, float viewport_height, float threshold_pixels = 1.0f) noexcept;
+
+		/// Orthographic camera showing view_height units over a viewport of the given height in pixels.
+		[[nodiscard]] static LodSelector orthographic(float view_height, float viewport_height, float threshold_pixels = 1.0f) noexcept;
+
+		/// On-screen size in pixels of an object-space error, for an object scaled by scale whose nearest point is
+		/// distance units from the camera. Distance is ignored by orthographic cameras.
+		[[nodiscard]] float project(float error, float distance, float scale = 1.0f) const noexcept;
+
+		/// Coarsest level whose error projects to no more than the threshold, or 0 if there are no levels.
+		[[nodiscard]] std::size_t select(const LodLevel* levels, std::size_t count, float distance, float scale = 1.0f) const noexcept;
+
+	};
+
+} // namespace coral
@@ -0,0 +1,311 @@
+#include "MeshOptimizer.h"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+namespace coral {
+
+	/// Clusters are split once their own ACMR, starting from a cold cache, is within this factor of the
+	/// whole mesh's. Lower keeps more cache efficiency, higher gives the overdraw sort more freedom.
+	static constexpr float OVERDRAW_THRESHOLD = 1.05f;
+
+	MeshOptimizer::Report MeshOptimizer::optimize(IndexedMesh& mesh, std::vector<MeshPool::Index>* vertex_sources)
+	{
+		Report report;
+		report.before = analyze_vertex_cache(mesh.indices, mesh.vertices.size());
+
+		if (mesh.indices.size() < 3u || mesh.indices.size() % 3u != 0u) {
+			report.after = report.before;
+			if (vertex_sources != nullptr) {
+				vertex_sources->resize(mesh.vertices.size());
+				std::iota(vertex_sources->begin(), vertex_sources->end(), MeshPool::Index{ 0u });
+			}
+			return report;
+		}
+
+		std::vector<std::uint32_t> cluster_starts;
+		std::vector<MeshPool::Index> cache_order = optimize_vertex_cache(mesh.indices, mesh.vertices.size(), &cluster_starts);
+		mesh.indices = optimize_overdraw(cache_order, mesh.vertices, cluster_starts);
+		std::vector<MeshPool::Index> sources = optimize_vertex_fetch(mesh);
+		if (vertex_sources != nullptr) {
+			*vertex_sources = std::move(sources);
+		}
+
+		report.after = analyze_vertex_cache(mesh.indices, mesh.vertices.size());
+		report.cluster_count = cluster_starts.size();
+		return report;
+	}
+
+	std::vector<MeshPool::Index> MeshOptimizer::optimize_vertex_cache(const std::vector<MeshPool::Index>& indices, std::size_t vertex_count,
+		std::vector<std::uint32_t>* cluster_starts)
+	{
+		// Tipsify, from Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"
+		std::size_t triangle_count = indices.size() / 3u;
+
+		// Triangles using each vertex, in compressed rows
+		std::vector<std::uint32_t> offsets(vertex_count + 1u, 0u);
+		for (MeshPool::Index index : indices) {
+			++offsets[index + 1u];
+		}
+		std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+		std::vector<std::uint32_t> adjacency(indices.size());
+		std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+		for (std::size_t i = 0u; i < indices.size(); ++i) {
+			adjacency[fill[indices[i]]++] = static_cast<std::uint32_t>(i / 3u);
+		}
+
+		std::vector<std::uint32_t> live(vertex_count);
+		for (std::size_t v = 0u; v < vertex_count; ++v) {
+			live[v] = offsets[v + 1u] - offsets[v];
+		}
+
+		std::vector<std::uint32_t> cache_time(vertex_count, 0u);
+		std::vector<bool> emitted(triangle_count, false);
+		std::vector<MeshPool::Index> dead_end;
+		std::vector<MeshPool::Index> candidates;
+		std::vector<MeshPool::Index> result;
+		dead_end.reserve(indices.size());
+		result.reserve(indices.size());
+
+		std::uint32_t time = CACHE_SIZE + 1u;
+		std::size_t cursor = 0u;
+
+		static constexpr std::int64_t NONE = -1;
+		std::int64_t fan = triangle_count > 0u ? indices[0] : NONE;
+		if (cluster_starts != nullptr && fan != NONE) {
+			cluster_starts->push_back(0u);
+		}
+
+		while (fan != NONE) {
+			// Emit every remaining triangle around the fanning vertex
+			candidates.clear();
+			for (std::uint32_t a = offsets[fan]; a < offsets[fan + 1]; ++a) {
+				std::uint32_t triangle = adjacency[a];
+				if (emitted[triangle]) {
+					continue;
+				}
+				emitted[triangle] = true;
+
+				for (std::size_t k = 0u; k < 3u; ++k) {
+					MeshPool::Index v = indices[triangle * 3u + k];
+					result.push_back(v);
+					dead_end.push_back(v);
+					candidates.push_back(v);
+					--live[v];
+					if (time - cache_time[v] > CACHE_SIZE) {
+						cache_time[v] = time++;
+					}
+				}
+			}
+
+			// Prefer the candidate that stays in the cache longest, as long as its fan still fits
+			std::int64_t best = NONE;
+			std::int64_t best_priority = -1;
+			for (MeshPool::Index v : candidates) {
+				if (live[v] == 0u) {
+					continue;
+				}
+				std::int64_t priority = 0;
+				if (time - cache_time[v] + 2u * live[v] <= CACHE_SIZE) {
+					priority = time - cache_time[v];
+				}
+				if (priority > best_priority) {
+					best = v;
+					best_priority = priority;
+				}
+			}
+
+			if (best == NONE) {
+				// Dead end: back up to a recently used vertex, or else the next unfinished one in input order
+				while (!dead_end.empty() && best == NONE) {
+					MeshPool::Index v = dead_end.back();
+					dead_end.pop_back();
+					if (live[v] > 0u) {
+						best = v;
+					}
+				}
+				while (cursor < vertex_count && best == NONE) {
+					if (live[cursor] > 0u) {
+						best = static_cast<std::int64_t>(cursor);
+					}
+					++cursor;
+				}
+
+				// Jumps are where locality breaks, so they make natural cluster boundaries
+				if (cluster_starts != nullptr && best != NONE) {
+					cluster_starts->push_back(static_cast<std::uint32_t>(result.size() / 3u));
+				}
+			}
+
+			fan = best;
+		}
+
+		return result;
+	}
+
+	std::vector<MeshPool::Index> MeshOptimizer::optimize_overdraw(const std::vector<MeshPool::Index>& indices, const std::vector<MeshPool::Vertex>& vertices,
+		std::vector<std::uint32_t>& cluster_starts)
+	{
+		std::uint32_t triangle_count = static_cast<std::uint32_t>(indices.size() / 3u);
+		if (cluster_starts.empty() || cluster_starts.front() != 0u) {
+			cluster_starts.insert(cluster_starts.begin(), 0u);
+		}
+
+		// Split clusters further once their cache cost from a cold start has settled near the mesh average
+		float target = analyze_vertex_cache(indices, vertices.size()).acmr * OVERDRAW_THRESHOLD;
+		std::vector<std::uint32_t> soft_starts;
+		std::vector<std::uint32_t> cache_time(vertices.size(), 0u);
+		std::uint32_t time = CACHE_SIZE + 1u;
+
+		for (std::size_t c = 0u; c < cluster_starts.size(); ++c) {
+			std::uint32_t end = c + 1u < cluster_starts.size() ? cluster_starts[c + 1u] : triangle_count;
+			std::uint32_t start = cluster_starts[c];
+			soft_starts.push_back(start);
+
+			// A gap larger than the cache empties it
+			time += CACHE_SIZE + 1u;
+			std::uint32_t misses = 0u;
+			for (std::uint32_t t = start; t < end; ++t) {
+				for (std::size_t k = 0u; k < 3u; ++k) {
+					MeshPool::Index v = indices[t * 3u + k];
+					if (time - cache_time[v] > CACHE_SIZE) {
+						cache_time[v] = time++;
+						++misses;
+					}
+				}
+
+				std::uint32_t length = t + 1u - soft_starts.back();
+				if (t + 1u < end && static_cast<float>(misses) <= target * length) {
+					soft_starts.push_back(t + 1u);
+					time += CACHE_SIZE + 1u;
+					misses = 0u;
+				}
+			}
+		}
+		cluster_starts = std::move(soft_starts);
+
+		// Outward-facing clusters far from the centre tend to occlude the others, so draw them first
+		glm::vec3 mesh_center{ 0.0f };
+		float mesh_area = 0.0f;
+
+		struct Cluster {
+			std::uint32_t start;
+			std::uint32_t end;
+			float sort_key;
+		};
+		std::vector<Cluster> clusters;
+		clusters.reserve(cluster_starts.size());
+
+		std::vector<glm::vec3> centers;
+		std::vector<glm::vec3> normals;
+		for (std::size_t c = 0u; c < cluster_starts.size(); ++c) {
+			Cluster cluster{ cluster_starts[c], c + 1u < cluster_starts.size() ? cluster_starts[c + 1u] : triangle_count, 0.0f };
+
+			glm::vec3 center{ 0.0f };
+			glm::vec3 normal{ 0.0f };
+			float area = 0.0f;
+			for (std::uint32_t t = cluster.start; t < cluster.end; ++t) {
+				const glm::vec3& a = vertices[indices[t * 3u + 0u]].position;
+				const glm::vec3& b = vertices[indices[t * 3u + 1u]].position;
+				const glm::vec3& d = vertices[indices[t * 3u + 2u]].position;
+
+				glm::vec3 cross = glm::cross(b - a, d - a);
+				float triangle_area = glm::length(cross);
+				center += (a + b + d) * (triangle_area / 3.0f);
+				normal += cross;
+				area += triangle_area;
+			}
+
+			mesh_center += center;
+			mesh_area += area;
+			centers.push_back(area > 0.0f ? center / area : center);
+			normals.push_back(normal);
+			clusters.push_back(cluster);
+		}
+		if (mesh_area > 0.0f) {
+			mesh_center /= mesh_area;
+		}
+
+		for (std::size_t c = 0u; c < clusters.size(); ++c) {
+			float length = glm::length(normals[c]);
+			clusters[c].sort_key = length > 0.0f ? glm::dot(centers[c] - mesh_center, normals[c] / length) : 0.0f;
+		}
+		std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.sort_key > b.sort_key; });
+
+		std::vector<MeshPool::Index> result;
+		result.reserve(indices.size());
+		for (const Cluster& cluster : clusters) {
+			result.insert(result.end(), indices.begin() + cluster.start * 3u, indices.begin() + cluster.end * 3u);
+		}
+		return result;
+	}
+
+	std::vector<MeshPool::Index> MeshOptimizer::optimize_vertex_fetch(IndexedMesh& mesh)
+	{
+		static constexpr MeshPool::Index UNUSED = ~MeshPool::Index{ 0u };
+		std::vector<MeshPool::Index> remap(mesh.vertices.size(), UNUSED);
+		std::vector<MeshPool::Index> sources;
+		std::vector<MeshPool::Vertex> vertices;
+		vertices.reserve(mesh.vertices.size());
+		sources.reserve(mesh.vertices.size());
+
+		// Vertices nothing refers to are dropped
+		for (MeshPool::Index& index : mesh.indices) {
+			if (remap[index] == UNUSED) {
+				remap[index] = static_cast<MeshPool::Index>(vertices.size());
+				vertices.push_back(mesh.vertices[index]);
+				sources.push_back(index);
+			}
+			index = remap[index];
+		}
+		mesh.vertices = std::move(vertices);
+		return sources;
+	}
+
+	MeshOptimizer::CacheStats MeshOptimizer::analyze_vertex_cache(const std::vector<MeshPool::Index>& indices, std::size_t vertex_count, std::uint32_t cache_size)
+	{
+		// Ratios per triangle mean nothing without a whole triangle
+		CacheStats stats;
+		if (indices.size() < 3u) {
+			return stats;
+		}
+
+		// FIFO: a vertex is cached while fewer than cache_size misses have happened since its own
+		std::vector<std::uint32_t> cache_time(vertex_count, 0u);
+		std::vector<bool> used(vertex_count, false);
+		std::uint32_t time = cache_size + 1u;
+		std::uint32_t misses = 0u;
+		std::uint32_t unique = 0u;
+		for (MeshPool::Index v : indices) {
+			if (time - cache_time[v] > cache_size) {
+				cache_time[v] = time++;
+				++misses;
+			}
+			if (!used[v]) {
+				used[v] = true;
+				++unique;
+			}
+		}
+
+		stats.acmr = static_cast<float>(misses) / (indices.size() / 3u);
+		stats.atvr = static_cast<float>(misses) / unique;
+		return stats;
+	}
+
+	void MeshOptimizer::print(const Report& report, const char* label)
+	{
+		// Formatted separately to leave the stream's own settings alone
+		std::ostringstream out;
+		out << std::fixed << std::setprecision(3) << label << ": ACMR " << report.before.acmr << " -> " << report.after.acmr
+			<< ", ATVR " << report.before.atvr << " -> " << report.after.atvr
+			<< ", " << report.cluster_count << " clusters\n";
+		std::cout << out.str();
+	}
+
+} // namespace coral
@@ -0,0 +1,262 @@
+#include "MeshPool.h"
+
+#include "Util.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+namespace coral {
+
+	static constexpr GLuint VERTEX_BINDING = 0u;
+	static constexpr GLuint INSTANCE_BINDING = 1u;
+	static constexpr GLuint INSTANCE_TRANSFORM_COLUMNS = 4u;
+	static_assert(AttributeLocation::INSTANCE_TRANSFORM + INSTANCE_TRANSFORM_COLUMNS <= AttributeLocation::INSTANCE_COLOR, "Transform columns overlap INSTANCE_COLOR");
+
+	MeshPool::MeshPool(std::uint32_t page_vertex_capacity, std::uint32_t page_index_capacity, const char* label)
+		: MeshPool(VertexFormat::of<Vertex>(), page_vertex_capacity, page_index_capacity, label)
+	{
+	}
+
+	MeshPool::MeshPool(VertexFormat format, std::uint32_t page_vertex_capacity, std::uint32_t page_index_capacity, const char* label)
+		: format(std::move(format)), page_vertex_capacity(page_vertex_capacity), page_index_capacity(page_index_capacity), label(label)
+	{
+		glGenVertexArrays(1, &vao);
+		glBindVertexArray(vao);
+		glObjectLabel(GL_VERTEX_ARRAY, vao, -1, label);
+
+		// The format is fixed; pages only swap the buffer behind the binding
+		this->format.apply(VERTEX_BINDING);
+
+		// Instance attributes are only enabled while an instance buffer is bound. The transform is a mat4,
+		// which takes one vec4 attribute per column.
+		for (GLuint column = 0u; column < INSTANCE_TRANSFORM_COLUMNS; ++column) {
+			GLuint location = AttributeLocation::INSTANCE_TRANSFORM + column;
+			glVertexAttribFormat(location, 4, GL_FLOAT, GL_FALSE, offsetof(Instance, transform) + sizeof(glm::vec4) * column);
+			glVertexAttribBinding(location, INSTANCE_BINDING);
+		}
+		glVertexAttribFormat(AttributeLocation::INSTANCE_COLOR, 4, GL_FLOAT, GL_FALSE, offsetof(Instance, color));
+		glVertexAttribFormat(AttributeLocation::INSTANCE_CUSTOM, 4, GL_FLOAT, GL_FALSE, offsetof(Instance, custom));
+		glVertexAttribBinding(AttributeLocation::INSTANCE_COLOR, INSTANCE_BINDING);
+		glVertexAttribBinding(AttributeLocation::INSTANCE_CUSTOM, INSTANCE_BINDING);
+		glVertexBindingDivisor(INSTANCE_BINDING, 1);
+
+		glBindVertexArray(NULL);
+	}
+
+	MeshPool::~MeshPool()
+	{
+		for (Page& page : pages) {
+			glDeleteBuffers(1, &page.vbo);
+			glDeleteBuffers(1, &page.ibo);
+		}
+		glDeleteVertexArrays(1, &vao);
+	}
+
+	MeshPool::Mesh MeshPool::add_bytes(const void* vertices, std::uint32_t vertex_count, const Index* indices, std::uint32_t index_count, const PositionQuantization& quantization)
+	{
+		Mesh mesh;
+		mesh.quantization = quantization;
+		mesh.vertex_count = vertex_count;
+		mesh.index_count = index_count;
+		mesh.index_type = vertex_count <= MAX_SHORT_INDEXED_VERTICES ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+		std::uint32_t unit_size = get_index_size(mesh.index_type) / 2u;
+		mesh.page = find_page(vertex_count, index_count > 0u ? index_count * unit_size + unit_size - 1u : 0u);
+
+		Page& page = pages[mesh.page];
+		mesh.base_vertex = page.vertices.allocate(vertex_count);
+		mesh.first_index = page.indices.allocate(index_count * unit_size, unit_size) / unit_size;
+
+		// The copy target leaves the VAO's element buffer binding alone
+		if (vertex_count > 0u) {
+			glBindBuffer(GL_COPY_WRITE_BUFFER, page.vbo);
+			GLsizeiptr stride = format.get_stride();
+			glBufferSubData(GL_COPY_WRITE_BUFFER, stride * mesh.base_vertex, stride * vertex_count, vertices);
+		}
+		if (index_count > 0u) {
+			glBindBuffer(GL_COPY_WRITE_BUFFER, page.ibo);
+			if (mesh.index_type == GL_UNSIGNED_SHORT) {
+				std::vector<std::uint16_t> narrow(indices, indices + index_count);
+				glBufferSubData(GL_COPY_WRITE_BUFFER, sizeof(std::uint16_t) * mesh.first_index, sizeof(std::uint16_t) * index_count, narrow.data());
+			} else {
+				glBufferSubData(GL_COPY_WRITE_BUFFER, sizeof(Index) * mesh.first_index, sizeof(Index) * index_count, indices);
+			}
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, NULL);
+
+		return mesh;
+	}
+
+	MeshPool::Mesh MeshPool::add_dedicated(const void* vertices, std::uint32_t vertex_count, const void* indices, std::uint32_t index_count, GLenum index_type,
+		const PositionQuantization& quantization)
+	{
+		Mesh mesh;
+		mesh.quantization = quantization;
+		mesh.vertex_count = vertex_count;
+		mesh.index_count = index_count;
+		mesh.index_type = index_type;
+
+		// The data fills the page exactly, so the whole page is allocated to this mesh. remove() deletes the page
+		// along with it.
+		std::uint32_t unit_size = get_index_size(index_type) / 2u;
+		mesh.page = create_page(vertex_count, index_count * unit_size, vertices, indices);
+
+		Page& page = pages[mesh.page];
+		page.dedicated = true;
+		mesh.base_vertex = page.vertices.allocate(vertex_count);
+		mesh.first_index = page.indices.allocate(index_count * unit_size) / unit_size;
+
+		return mesh;
+	}
+
+	void MeshPool::remove(const Mesh& mesh)
+	{
+		Page& page = pages.at(mesh.page);
+		std::uint32_t unit_size = get_index_size(mesh.index_type) / 2u;
+		page.vertices.free(mesh.base_vertex, mesh.vertex_count);
+		page.indices.free(mesh.first_index * unit_size, mesh.index_count * unit_size);
+
+		// Nothing else was ever placed in a dedicated page, so its memory can go back to the driver
+		if (page.dedicated) {
+			glDeleteBuffers(1, &page.vbo);
+			glDeleteBuffers(1, &page.ibo);
+			page = Page{ 0u, 0u, RangeAllocator(0u), RangeAllocator(0u) };
+			if (bound_page == mesh.page) {
+				bound_page = NO_PAGE;
+			}
+		}
+	}
+
+	void MeshPool::bind()
+	{
+		glBindVertexArray(vao);
+		bound_page = NO_PAGE;
+	}
+
+	void MeshPool::unbind()
+	{
+		glBindVertexArray(NULL);
+		bound_page = NO_PAGE;
+	}
+
+	void MeshPool::draw(const Mesh& mesh, GLenum mode)
+	{
+		if (mesh.page != bound_page) {
+			bind_page(mesh.page);
+		}
+		set_quantization(mesh);
+
+		if (mesh.index_count > 0u) {
+			void* offset = reinterpret_cast<void*>(std::uintptr_t{ get_index_size(mesh.index_type) } * mesh.first_index);
+			glDrawElementsBaseVertex(mode, mesh.index_count, mesh.index_type, offset, mesh.base_vertex);
+		} else {
+			glDrawArrays(mode, mesh.base_vertex, mesh.vertex_count);
+		}
+	}
+
+	void MeshPool::draw_instanced(const Mesh& mesh, GLenum mode, GLuint instance_buffer, GLintptr offset, GLsizei instance_count)
+	{
+		if (mesh.page != bound_page) {
+			bind_page(mesh.page);
+		}
+		set_quantization(mesh);
+
+		glBindVertexBuffer(INSTANCE_BINDING, instance_buffer, offset, sizeof(Instance));
+		for (GLuint column = 0u; column < INSTANCE_TRANSFORM_COLUMNS; ++column) {
+			glEnableVertexAttribArray(AttributeLocation::INSTANCE_TRANSFORM + column);
+		}
+		glEnableVertexAttribArray(AttributeLocation::INSTANCE_COLOR);
+		glEnableVertexAttribArray(AttributeLocation::INSTANCE_CUSTOM);
+
+		if (mesh.index_count > 0u) {
+			void* indices = reinterpret_cast<void*>(std::uintptr_t{ get_index_size(mesh.index_type) } * mesh.first_index);
+			glDrawElementsInstancedBaseVertex(mode, mesh.index_count, mesh.index_type, indices, instance_count, mesh.base_vertex);
+		} else {
+			glDrawArraysInstanced(mode, mesh.base_vertex, mesh.vertex_count, instance_count);
+		}
+
+		for (GLuint column = 0u; column < INSTANCE_TRANSFORM_COLUMNS; ++column) {
+			glDisableVertexAttribArray(AttributeLocation::INSTANCE_TRANSFORM + column);
+		}
+		glDisableVertexAttribArray(AttributeLocation::INSTANCE_COLOR);
+		glDisableVertexAttribArray(AttributeLocation::INSTANCE_CUSTOM);
+	}
+
+	void MeshPool::set_quantization(const Mesh& mesh)
+	{
+		// Constant attribute values are context state, so any shader can read them without a uniform
+		if (format.has_quantized_position()) {
+			glVertexAttrib3fv(AttributeLocation::POSITION_SCALE, &mesh.quantization.scale.x);
+			glVertexAttrib3fv(AttributeLocation::POSITION_OFFSET, &mesh.quantization.offset.x);
+		}
+	}
+
+	void MeshPool::print_stats() const
+	{
+		Util::print_divider("Mesh Pool Begin");
+
+		std::cout << label << ": " << pages.size() << " pages, " << format.get_stride() << " bytes per vertex\n";
+		for (std::size_t i = 0u; i < pages.size(); ++i) {
+			const Page& page = pages[i];
+			std::cout << "Page " << i
+				<< ": vertices " << page.vertices.get_capacity() - page.vertices.get_free() << " / " << page.vertices.get_capacity()
+				<< " (" << page.vertices.get_free_range_count() << " free ranges)"
+				<< ", index bytes " << 2u * (page.indices.get_capacity() - page.indices.get_free()) << " / " << 2u * page.indices.get_capacity()
+				<< " (" << page.indices.get_free_range_count() << " free ranges)\n";
+		}
+
+		Util::print_divider("Mesh Pool End");
+	}
+
+	std::uint32_t MeshPool::find_page(std::uint32_t vertex_count, std::uint32_t index_units)
+	{
+		// index_units includes worst-case alignment padding, so any page passing this check has room
+		for (std::uint32_t i = 0u; i < pages.size(); ++i) {
+			if (pages[i].vbo != 0u && pages[i].vertices.get_largest_free() >= vertex_count && pages[i].indices.get_largest_free() >= index_units) {
+				return i;
+			}
+		}
+
+		return create_page(std::max(vertex_count, page_vertex_capacity), std::max(index_units, page_index_capacity * 2u), nullptr, nullptr);
+	}
+
+	std::uint32_t MeshPool::create_page(std::uint32_t vertex_capacity, std::uint32_t index_units, const void* vertex_data, const void* index_data)
+	{
+		std::uint32_t number = 0u;
+		while (number < pages.size() && pages[number].vbo != 0u) {
+			++number;
+		}
+		std::string page_label = label + ".Page" + std::to_string(number);
+
+		Page page{ 0u, 0u, RangeAllocator(vertex_capacity), RangeAllocator(index_units) };
+
+		glGenBuffers(1, &page.vbo);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, page.vbo);
+		glObjectLabel(GL_BUFFER, page.vbo, -1, (page_label + ".VBO").c_str());
+		glBufferStorage(GL_COPY_WRITE_BUFFER, GLsizeiptr{ format.get_stride() } * page.vertices.get_capacity(), vertex_data, GL_DYNAMIC_STORAGE_BIT);
+
+		if (page.indices.get_capacity() > 0u) {
+			glGenBuffers(1, &page.ibo);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, page.ibo);
+			glObjectLabel(GL_BUFFER, page.ibo, -1, (page_label + ".IBO").c_str());
+			glBufferStorage(GL_COPY_WRITE_BUFFER, sizeof(std::uint16_t) * page.indices.get_capacity(), index_data, GL_DYNAMIC_STORAGE_BIT);
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, NULL);
+
+		if (number < pages.size()) {
+			pages[number] = std::move(page);
+		} else {
+			pages.push_back(std::move(page));
+		}
+		return number;
+	}
+
+	void MeshPool::bind_page(std::uint32_t page)
+	{
+		glBindVertexBuffer(VERTEX_BINDING, pages[page].vbo, 0, format.get_stride());
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pages[page].ibo);
+		bound_page = page;
+	}
+
+} // namespace coral
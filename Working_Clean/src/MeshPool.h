@@ -0,0 +1,163 @@
+#pragma once
+
+#include "RangeAllocator.h"
+#include "VertexFormat.h"
+
+#include <glew/glew.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace coral {
+
+	/// Shared storage for meshes of one vertex format, described by a VertexLayout. Vertex is the default.
+	///
+	/// Vertices and indices are suballocated from a few large immutable buffers ("pages") instead of one buffer
+	/// per mesh. All pages share a single VAO, and meshes are addressed by base vertex and first index, so
+	/// drawing many meshes only rebinds buffers when moving to a mesh on another page. A new page is created
+	/// when no existing one has room. Instanced draws read a per-instance attribute stream from a second
+	/// buffer binding.
+	///
+	/// Indices are relative to the mesh's base vertex, so meshes with at most 65536 vertices are stored with
+	/// 16-bit indices and larger ones with 32-bit indices, sharing the same index buffers.
+	class MeshPool {
+	public:
+
+		struct Vertex {
+			glm::vec3 position;
+		};
+
+		using Index = std::uint32_t;
+
+		/// Per-instance attributes, advanced once per instance.
+		struct Instance {
+			/// Model matrix, read by shaders as a mat4 at INSTANCE_TRANSFORM.
+			glm::mat4 transform;
+			glm::vec4 color;
+			/// Free for shaders to interpret.
+			glm::vec4 custom;
+		};
+
+		/// Location of a mesh within the pool.
+		struct Mesh {
+			/// Only used by formats with quantized positions.
+			PositionQuantization quantization{};
+			std::uint32_t page = 0u;
+			std::uint32_t base_vertex = 0u;
+			std::uint32_t vertex_count = 0u;
+			/// In units of index_type.
+			std::uint32_t first_index = 0u;
+			std::uint32_t index_count = 0u;
+			GLenum index_type = GL_UNSIGNED_INT;
+		};
+
+		/// Meshes with more vertices than this need 32-bit indices.
+		static constexpr std::uint32_t MAX_SHORT_INDEXED_VERTICES = 65536u;
+
+	private:
+
+		static constexpr std::uint32_t NO_PAGE = ~std::uint32_t{ 0u };
+
+		struct Page {
+			GLuint vbo = 0u;
+			GLuint ibo = 0u;
+			RangeAllocator vertices;
+			/// In 16-bit units; 32-bit indices take two aligned units each.
+			RangeAllocator indices;
+			/// Created by add_dedicated, and released again with its mesh.
+			bool dedicated = false;
+		};
+
+		VertexFormat format;
+		GLuint vao = 0u;
+		std::vector<Page> pages{};
+		std::uint32_t bound_page = NO_PAGE;
+
+		std::uint32_t page_vertex_capacity;
+		std::uint32_t page_index_capacity;
+		std::string label;
+
+	public:
+
+		/// Capacities are per page, the index capacity in 32-bit indices. Larger meshes get a page of their own.
+		MeshPool(std::uint32_t page_vertex_capacity, std::uint32_t page_index_capacity, const char* label);
+
+		/// Pool of another vertex struct, e.g. VertexFormat::of<PackedVertex>().
+		MeshPool(VertexFormat format, std::uint32_t page_vertex_capacity, std::uint32_t page_index_capacity, const char* label);
+		~MeshPool();
+
+		MeshPool(const MeshPool&) = delete;
+		MeshPool& operator=(const MeshPool&) = delete;
+
+		/// Upload a mesh. Indices are relative to the mesh's first vertex and may be omitted.
+		/// The narrowest index type that can address every vertex is picked automatically.
+		/// The vertex struct must match the pool's format.
+		template<typename V>
+		[[nodiscard]] Mesh add(const V* vertices, std::uint32_t vertex_count, const Index* indices = nullptr, std::uint32_t index_count = 0u,
+			const PositionQuantization& quantization = {})
+		{
+			if (!format.is<V>()) {
+				throw std::invalid_argument("Vertex type does not match the mesh pool's format");
+			}
+			return add_bytes(vertices, vertex_count, indices, index_count, quantization);
+		}
+
+		/// Upload a mesh into a new page of its own, creating the buffers straight from the given memory, such as
+		/// sections of a mapped MeshFile. Vertices must be in the pool's format and indices already of index_type.
+		/// The page's buffers are deleted when the mesh is removed.
+		[[nodiscard]] Mesh add_dedicated(const void* vertices, std::uint32_t vertex_count, const void* indices, std::uint32_t index_count, GLenum index_type,
+			const PositionQuantization& quantization = {});
+
+		/// Release a mesh's ranges for reuse.
+		void remove(const Mesh& mesh);
+
+		/// Bind the shared VAO. Meshes may only be drawn between bind and unbind.
+		void bind();
+		void unbind();
+
+		/// Draw a mesh, indexed if it has indices.
+		void draw(const Mesh& mesh, GLenum mode);
+
+		/// Draw instances of a mesh reading Instance attributes from a buffer, starting at offset.
+		void draw_instanced(const Mesh& mesh, GLenum mode, GLuint instance_buffer, GLintptr offset, GLsizei instance_count);
+
+		/// Bind the buffers of one page to the shared VAO, e.g. before a multi-draw covering that page.
+		void bind_page(std::uint32_t page);
+
+		[[nodiscard]] std::size_t get_page_count() const noexcept { return pages.size(); }
+		[[nodiscard]] const VertexFormat& get_format() const noexcept { return format; }
+
+		/// Bytes per index of GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+		[[nodiscard]] static constexpr std::uint32_t get_index_size(GLenum type) noexcept { return type == GL_UNSIGNED_SHORT ? 2u : 4u; }
+
+		void print_stats() const;
+
+	private:
+
+		Mesh add_bytes(const void* vertices, std::uint32_t vertex_count, const Index* indices, std::uint32_t index_count, const PositionQuantization& quantization);
+
+		/// Set the per-draw constant attributes of meshes with quantized positions.
+		void set_quantization(const Mesh& mesh);
+
+		/// Page with room for the mesh, creating one if needed.
+		std::uint32_t find_page(std::uint32_t vertex_count, std::uint32_t index_units);
+
+		/// New page with the given capacities, its buffers initialized from the data if not null.
+		/// Reuses the slot of a released dedicated page, so page numbers stay stable.
+		std::uint32_t create_page(std::uint32_t vertex_capacity, std::uint32_t index_units, const void* vertex_data, const void* index_data);
+
+	};
+
+	template<>
+	struct VertexLayout<MeshPool::Vertex> {
+		static constexpr std::array<VertexAttribute, 1> ATTRIBUTES = {
+			CORAL_VERTEX_ATTRIBUTE(MeshPool::Vertex, position, AttributeLocation::POSITION),
+		};
+	};
+
+} // namespace coral
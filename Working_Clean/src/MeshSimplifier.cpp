@@ -0,0 +1,448 @@
+#include "MeshSimplifier.h"
+
+#include "MeshOptimizer.h"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace coral {
+
+	/// Border planes are weighted by this times the squared edge length, so open edges barely move.
+	static constexpr double BORDER_WEIGHT = 10.0;
+
+	/// Collapses turning a triangle's normal by more than about 75 degrees are rejected as folds.
+	static constexpr float MIN_NORMAL_COSINE = 0.25f;
+
+	/// Symmetric 4x4 matrix summing squared plane distances: value(p) = p'Ap + 2b'p + c, weighted by area.
+	struct Quadric {
+		double a00 = 0.0, a11 = 0.0, a22 = 0.0, a01 = 0.0, a02 = 0.0, a12 = 0.0;
+		double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+		double c = 0.0;
+		double weight = 0.0;
+
+		/// Plane through point with unit normal.
+		static Quadric from_plane(const glm::dvec3& normal, const glm::dvec3& point, double weight) noexcept
+		{
+			double d = -glm::dot(normal, point);
+			Quadric q;
+			q.a00 = weight * normal.x * normal.x;
+			q.a11 = weight * normal.y * normal.y;
+			q.a22 = weight * normal.z * normal.z;
+			q.a01 = weight * normal.x * normal.y;
+			q.a02 = weight * normal.x * normal.z;
+			q.a12 = weight * normal.y * normal.z;
+			q.b0 = weight * normal.x * d;
+			q.b1 = weight * normal.y * d;
+			q.b2 = weight * normal.z * d;
+			q.c = weight * d * d;
+			q.weight = weight;
+			return q;
+		}
+
+		Quadric& operator+=(const Quadric& other) noexcept
+		{
+			a00 += other.a00; a11 += other.a11; a22 += other.a22;
+			a01 += other.a01; a02 += other.a02; a12 += other.a12;
+			b0 += other.b0; b1 += other.b1; b2 += other.b2;
+			c += other.c;
+			weight += other.weight;
+			return *this;
+		}
+
+		[[nodiscard]] double evaluate(const glm::dvec3& p) const noexcept
+		{
+			double value = a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z
+				+ 2.0 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z)
+				+ 2.0 * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+			return std::max(value, 0.0);
+		}
+	};
+
+	/// Candidate half-edge collapse, valid while neither vertex has changed since it was queued.
+	struct EdgeCollapse {
+		float error;
+		MeshPool::Index from;
+		MeshPool::Index to;
+		std::uint32_t from_version;
+		std::uint32_t to_version;
+
+		bool operator>(const EdgeCollapse& other) const noexcept { return error > other.error; }
+	};
+
+	/// Simplification state, kept between levels of a chain so each level continues from the last.
+	struct EdgeCollapser {
+
+		enum Flags : std::uint8_t {
+			/// Never moved: seams, non-manifold edges and degenerate input.
+			LOCKED = 1u,
+			/// On an open edge; may only slide along it.
+			BORDER = 2u,
+			REMOVED = 4u,
+		};
+
+		const std::vector<MeshPool::Vertex>& vertices;
+		std::vector<MeshPool::Index> indices;
+		std::vector<bool> triangle_alive;
+		std::vector<std::vector<std::uint32_t>> vertex_triangles;
+		std::vector<Quadric> quadrics;
+		std::vector<std::uint32_t> versions;
+		std::vector<std::uint8_t> flags;
+		std::priority_queue<EdgeCollapse, std::vector<EdgeCollapse>, std::greater<EdgeCollapse>> queue{};
+		std::size_t live_triangles;
+		float error = 0.0f;
+
+		/// Scratch for neighbourhood checks.
+		std::vector<MeshPool::Index> from_neighbours{};
+		std::vector<MeshPool::Index> to_neighbours{};
+
+		EdgeCollapser(const IndexedMesh& mesh)
+			: vertices(mesh.vertices), indices(mesh.indices), triangle_alive(mesh.indices.size() / 3u, true), vertex_triangles(mesh.vertices.size()),
+			quadrics(mesh.vertices.size()), versions(mesh.vertices.size(), 0u), flags(mesh.vertices.size(), 0u), live_triangles(mesh.indices.size() / 3u)
+		{
+			// Vertices sharing a position are split on some attribute; moving either would tear the surface
+			auto hash = [](const glm::vec3& p) {
+				// Adding zero turns -0 into +0, which compare equal
+				glm::vec3 canonical = p + glm::vec3{ 0.0f };
+				std::uint32_t bits[3];
+				std::memcpy(bits, &canonical, sizeof(bits));
+				return static_cast<std::size_t>((bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u));
+			};
+			std::unordered_map<glm::vec3, MeshPool::Index, decltype(hash)> positions(vertices.size(), hash);
+			for (MeshPool::Index v = 0u; v < vertices.size(); ++v) {
+				auto [it, inserted] = positions.emplace(vertices[v].position, v);
+				if (!inserted) {
+					flags[v] |= LOCKED;
+					flags[it->second] |= LOCKED;
+				}
+			}
+
+			// Triangles per undirected edge find borders and non-manifold edges
+			auto edge_key = [](MeshPool::Index a, MeshPool::Index b) {
+				return a < b ? (std::uint64_t{ a } << 32u) | b : (std::uint64_t{ b } << 32u) | a;
+			};
+			std::unordered_map<std::uint64_t, std::uint32_t> edge_triangles(indices.size());
+			for (std::size_t t = 0u; t < triangle_alive.size(); ++t) {
+				const MeshPool::Index* triangle = &indices[t * 3u];
+				for (std::size_t k = 0u; k < 3u; ++k) {
+					vertex_triangles[triangle[k]].push_back(static_cast<std::uint32_t>(t));
+					++edge_triangles[edge_key(triangle[k], triangle[(k + 1u) % 3u])];
+				}
+			}
+
+			for (std::size_t t = 0u; t < triangle_alive.size(); ++t) {
+				const MeshPool::Index* triangle = &indices[t * 3u];
+				glm::dvec3 p0{ vertices[triangle[0]].position };
+				glm::dvec3 p1{ vertices[triangle[1]].position };
+				glm::dvec3 p2{ vertices[triangle[2]].position };
+				glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+				double length = glm::length(normal);
+				if (length == 0.0 || triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2]) {
+					for (std::size_t k = 0u; k < 3u; ++k) {
+						flags[triangle[k]] |= LOCKED;
+					}
+					continue;
+				}
+
+				normal /= length;
+				Quadric plane = Quadric::from_plane(normal, p0, length * 0.5);
+				for (std::size_t k = 0u; k < 3u; ++k) {
+					quadrics[triangle[k]] += plane;
+				}
+
+				for (std::size_t k = 0u; k < 3u; ++k) {
+					MeshPool::Index a = triangle[k];
+					MeshPool::Index b = triangle[(k + 1u) % 3u];
+					std::uint32_t count = edge_triangles[edge_key(a, b)];
+					if (count == 1u) {
+						// Plane through the edge, perpendicular to the triangle
+						glm::dvec3 pa{ vertices[a].position };
+						glm::dvec3 edge = glm::dvec3{ vertices[b].position } - pa;
+						glm::dvec3 border_normal = glm::cross(edge, normal);
+						double border_length = glm::length(border_normal);
+						if (border_length > 0.0) {
+							Quadric border = Quadric::from_plane(border_normal / border_length, pa, BORDER_WEIGHT * glm::dot(edge, edge));
+							quadrics[a] += border;
+							quadrics[b] += border;
+						}
+						flags[a] |= BORDER;
+						flags[b] |= BORDER;
+					} else if (count > 2u) {
+						flags[a] |= LOCKED;
+						flags[b] |= LOCKED;
+					}
+				}
+			}
+
+			// Interior edges are queued twice per direction; the copies are harmless
+			for (std::size_t t = 0u; t < triangle_alive.size(); ++t) {
+				const MeshPool::Index* triangle = &indices[t * 3u];
+				for (std::size_t k = 0u; k < 3u; ++k) {
+					push(triangle[k], triangle[(k + 1u) % 3u]);
+					push(triangle[(k + 1u) % 3u], triangle[k]);
+				}
+			}
+		}
+
+		void push(MeshPool::Index from, MeshPool::Index to)
+		{
+			if ((flags[from] & (LOCKED | REMOVED)) != 0u || (flags[to] & REMOVED) != 0u || from == to) {
+				return;
+			}
+
+			Quadric merged = quadrics[from];
+			merged += quadrics[to];
+			double value = merged.weight > 0.0 ? merged.evaluate(glm::dvec3{ vertices[to].position }) / merged.weight : 0.0;
+			queue.push(EdgeCollapse{ static_cast<float>(std::sqrt(value)), from, to, versions[from], versions[to] });
+		}
+
+		/// Other vertices of the live triangles around a vertex, sorted and unique.
+		void gather_neighbours(MeshPool::Index vertex, std::vector<MeshPool::Index>& neighbours) const
+		{
+			neighbours.clear();
+			for (std::uint32_t t : vertex_triangles[vertex]) {
+				if (!triangle_alive[t]) {
+					continue;
+				}
+				for (std::size_t k = 0u; k < 3u; ++k) {
+					if (indices[t * 3u + k] != vertex) {
+						neighbours.push_back(indices[t * 3u + k]);
+					}
+				}
+			}
+			std::sort(neighbours.begin(), neighbours.end());
+			neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+		}
+
+		[[nodiscard]] bool is_valid(const EdgeCollapse& collapse)
+		{
+			// Triangles on the edge; zero means the edge no longer exists
+			std::uint32_t shared = 0u;
+			for (std::uint32_t t : vertex_triangles[collapse.from]) {
+				if (triangle_alive[t] && (indices[t * 3u] == collapse.to || indices[t * 3u + 1u] == collapse.to || indices[t * 3u + 2u] == collapse.to)) {
+					++shared;
+				}
+			}
+			if (shared == 0u || shared > 2u) {
+				return false;
+			}
+
+			// Border vertices may only move along their border, or the hole they bound would grow
+			if ((flags[collapse.from] & BORDER) != 0u && shared != 1u) {
+				return false;
+			}
+
+			// Link condition: the vertices may only share the neighbours opposite the edge, or the mesh pinches
+			gather_neighbours(collapse.from, from_neighbours);
+			gather_neighbours(collapse.to, to_neighbours);
+			std::size_t common = 0u;
+			for (auto a = from_neighbours.begin(), b = to_neighbours.begin(); a != from_neighbours.end() && b != to_neighbours.end();) {
+				if (*a < *b) {
+					++a;
+				} else if (*b < *a) {
+					++b;
+				} else {
+					++common;
+					++a;
+					++b;
+				}
+			}
+			if (common != shared) {
+				return false;
+			}
+
+			// Triangles that move must not fold over
+			const glm::vec3& target = vertices[collapse.to].position;
+			for (std::uint32_t t : vertex_triangles[collapse.from]) {
+				const MeshPool::Index* triangle = &indices[t * 3u];
+				if (!triangle_alive[t] || triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) {
+					continue;
+				}
+
+				glm::vec3 before[3];
+				glm::vec3 after[3];
+				for (std::size_t k = 0u; k < 3u; ++k) {
+					before[k] = vertices[triangle[k]].position;
+					after[k] = triangle[k] == collapse.from ? target : before[k];
+				}
+				glm::vec3 normal_before = glm::cross(before[1] - before[0], before[2] - before[0]);
+				glm::vec3 normal_after = glm::cross(after[1] - after[0], after[2] - after[0]);
+				float lengths = glm::length(normal_before) * glm::length(normal_after);
+				if (lengths == 0.0f || glm::dot(normal_before, normal_after) < MIN_NORMAL_COSINE * lengths) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		void collapse(const EdgeCollapse& collapse)
+		{
+			MeshPool::Index from = collapse.from;
+			MeshPool::Index to = collapse.to;
+
+			std::vector<std::uint32_t>& target_triangles = vertex_triangles[to];
+			for (std::uint32_t t : vertex_triangles[from]) {
+				if (!triangle_alive[t]) {
+					continue;
+				}
+				MeshPool::Index* triangle = &indices[t * 3u];
+				if (triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+					triangle_alive[t] = false;
+					--live_triangles;
+				} else {
+					std::replace(triangle, triangle + 3, from, to);
+					target_triangles.push_back(t);
+				}
+			}
+			vertex_triangles[from].clear();
+			target_triangles.erase(std::remove_if(target_triangles.begin(), target_triangles.end(), [&](std::uint32_t t) { return !triangle_alive[t]; }),
+				target_triangles.end());
+
+			quadrics[to] += quadrics[from];
+			flags[from] |= REMOVED;
+			++versions[from];
+			++versions[to];
+			error = std::max(error, collapse.error);
+
+			// Every edge around the merged vertex now has a new cost
+			gather_neighbours(to, to_neighbours);
+			for (MeshPool::Index neighbour : to_neighbours) {
+				push(to, neighbour);
+				push(neighbour, to);
+			}
+		}
+
+		/// Collapse until the target is met. Stops early where the next collapse would exceed the error.
+		void run(std::size_t target_triangles, float target_error)
+		{
+			while (live_triangles > target_triangles && !queue.empty()) {
+				EdgeCollapse next = queue.top();
+				if (next.from_version != versions[next.from] || next.to_version != versions[next.to] || (flags[next.from] & REMOVED) != 0u
+					|| (flags[next.to] & REMOVED) != 0u) {
+					queue.pop();
+					continue;
+				}
+				if (next.error > target_error) {
+					// Left queued for the next level
+					return;
+				}
+
+				queue.pop();
+				if (is_valid(next)) {
+					collapse(next);
+				}
+			}
+		}
+
+		[[nodiscard]] std::vector<MeshPool::Index> get_indices() const
+		{
+			std::vector<MeshPool::Index> result;
+			result.reserve(live_triangles * 3u);
+			for (std::size_t t = 0u; t < triangle_alive.size(); ++t) {
+				if (triangle_alive[t]) {
+					result.insert(result.end(), indices.begin() + t * 3u, indices.begin() + t * 3u + 3u);
+				}
+			}
+			return result;
+		}
+	};
+
+	std::vector<MeshPool::Index> MeshSimplifier::simplify(const IndexedMesh& mesh, std::size_t target_index_count, float target_error, float* result_error)
+	{
+		if (mesh.indices.size() % 3u != 0u) {
+			throw std::invalid_argument("Only triangle lists can be simplified");
+		}
+
+		EdgeCollapser collapser(mesh);
+		collapser.run(target_index_count / 3u, target_error);
+		if (result_error != nullptr) {
+			*result_error = collapser.error;
+		}
+		return collapser.get_indices();
+	}
+
+	LodChain MeshSimplifier::build_lod_chain(const IndexedMesh& mesh, const LodSettings& settings, std::vector<MeshPool::Index>* vertex_sources)
+	{
+		if (mesh.indices.size() % 3u != 0u) {
+			throw std::invalid_argument("Only triangle lists can be simplified");
+		}
+
+		LodChain chain;
+		chain.mesh.vertices = mesh.vertices;
+
+		// Full detail gets every pass; the simplified levels keep the overdraw order they inherit
+		if (settings.optimize) {
+			std::vector<std::uint32_t> cluster_starts;
+			std::vector<MeshPool::Index> cache_order = MeshOptimizer::optimize_vertex_cache(mesh.indices, mesh.vertices.size(), &cluster_starts);
+			chain.mesh.indices = MeshOptimizer::optimize_overdraw(cache_order, mesh.vertices, cluster_starts);
+		} else {
+			chain.mesh.indices = mesh.indices;
+		}
+		chain.levels.push_back(LodLevel{ 0u, static_cast<std::uint32_t>(chain.mesh.indices.size()), 0.0f });
+
+		// Simplifying the reordered list keeps surviving triangles in that order
+		IndexedMesh ordered{ mesh.vertices, chain.mesh.indices };
+		EdgeCollapser collapser(ordered);
+		float radius = get_radius(mesh);
+		for (float target : settings.target_errors) {
+			collapser.run(0u, target * radius);
+
+			std::size_t previous_count = chain.levels.back().index_count;
+			if (static_cast<float>(collapser.live_triangles * 3u) > static_cast<float>(previous_count) * settings.max_triangle_ratio || collapser.live_triangles == 0u) {
+				continue;
+			}
+
+			std::vector<MeshPool::Index> level = collapser.get_indices();
+			if (settings.optimize) {
+				level = MeshOptimizer::optimize_vertex_cache(level, mesh.vertices.size());
+			}
+			chain.levels.push_back(LodLevel{ static_cast<std::uint32_t>(chain.mesh.indices.size()), static_cast<std::uint32_t>(level.size()), collapser.error });
+			chain.mesh.indices.insert(chain.mesh.indices.end(), level.begin(), level.end());
+		}
+
+		// Vertices in order of first use across every level, finest first
+		std::vector<MeshPool::Index> sources;
+		if (settings.optimize) {
+			sources = MeshOptimizer::optimize_vertex_fetch(chain.mesh);
+		} else {
+			sources.resize(chain.mesh.vertices.size());
+			std::iota(sources.begin(), sources.end(), MeshPool::Index{ 0u });
+		}
+		if (vertex_sources != nullptr) {
+			*vertex_sources = std::move(sources);
+		}
+		return chain;
+	}
+
+	float MeshSimplifier::get_radius(const IndexedMesh& mesh) noexcept
+	{
+		if (mesh.vertices.empty()) {
+			return 0.0f;
+		}
+
+		glm::vec3 min = mesh.vertices[0].position;
+		glm::vec3 max = min;
+		for (const MeshPool::Vertex& vertex : mesh.vertices) {
+			min = glm::min(min, vertex.position);
+			max = glm::max(max, vertex.position);
+		}
+
+		glm::vec3 center = (min + max) * 0.5f;
+		float radius = 0.0f;
+		for (const MeshPool::Vertex& vertex : mesh.vertices) {
+			radius = std::max(radius, glm::distance(center, vertex.position));
+		}
+		return radius;
+	}
+
+} // namespace coral
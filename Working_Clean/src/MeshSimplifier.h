@@ -0,0 +1,56 @@
+#pragma once
+
+#include "MeshLod.h"
+#include "MeshUtil.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace coral {
+
+	/// Levels of detail sharing one set of vertices, ready for Model::set_lods or MeshFile::write.
+	struct LodChain {
+		/// Indices of every level back to back, finest first.
+		IndexedMesh mesh{};
+		std::vector<LodLevel> levels{};
+	};
+
+	/// How MeshSimplifier::build_lod_chain spaces its levels.
+	struct LodSettings {
+		/// Error allowed at each level after the first, relative to the mesh's bounding radius. Ascending.
+		std::vector<float> target_errors{ 0.002f, 0.008f, 0.03f, 0.1f };
+		/// Levels keeping more than this fraction of the previous level's triangles are left out.
+		float max_triangle_ratio = 0.75f;
+		/// Reorder triangles and vertices like MeshOptimizer::optimize. Without it every level keeps the source
+		/// triangle order and the vertices stay where they are.
+		bool optimize = true;
+	};
+
+	/// Quadric error edge-collapse simplification of triangle lists. No GL calls, so it runs anywhere.
+	///
+	/// Each vertex accumulates the planes of its triangles as a quadric, whose value at a point is the squared
+	/// distance to those planes. Edges are collapsed cheapest first, moving one vertex onto the other, so every
+	/// level keeps using a subset of the original vertices and their attributes. The error of a collapse is the
+	/// area-weighted RMS distance from the merged planes. Collapses that would flip triangles or make the mesh
+	/// non-manifold are skipped, open borders are held in place by extra planes along them, and vertices shared
+	/// with another vertex at the same position, such as UV seams, are never moved.
+	class MeshSimplifier {
+	public:
+
+		/// Collapse edges until at most target_index_count indices remain or the next collapse would exceed
+		/// target_error, an object-space distance. Returns indices into the same vertices. The error reached
+		/// is written to result_error if not null.
+		[[nodiscard]] static std::vector<MeshPool::Index> simplify(const IndexedMesh& mesh, std::size_t target_index_count, float target_error,
+			float* result_error = nullptr);
+
+		/// Simplify a triangle list once per target error, continuing from the previous level each time, and
+		/// optimize the result like MeshOptimizer::optimize unless settings say not to. The first level is the
+		/// full mesh. See MeshOptimizer::optimize_vertex_fetch for vertex_sources.
+		[[nodiscard]] static LodChain build_lod_chain(const IndexedMesh& mesh, const LodSettings& settings = {}, std::vector<MeshPool::Index>* vertex_sources = nullptr);
+
+		/// Distance from the centre of the mesh's bounding box to its furthest vertex.
+		[[nodiscard]] static float get_radius(const IndexedMesh& mesh) noexcept;
+
+	};
+
+} // namespace coral
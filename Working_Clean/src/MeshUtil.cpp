@@ -0,0 +1,72 @@
+#include "MeshUtil.h"
+
+#include "Util.h"
+
+#include <cstring>
+#include <unordered_map>
+
+namespace coral {
+
+	IndexedMesh MeshUtil::weld(const MeshPool::Vertex* vertices, std::uint32_t vertex_count, const MeshPool::Index* indices, std::uint32_t index_count)
+	{
+		static_assert(sizeof(MeshPool::Vertex) == sizeof(glm::vec3), "Vertex must not contain padding to be compared bitwise");
+
+		// Maps every input vertex to its welded index, computed on first use
+		static constexpr MeshPool::Index UNSEEN = ~MeshPool::Index{ 0u };
+		std::vector<MeshPool::Index> remap(vertex_count, UNSEEN);
+		auto hash = [](const MeshPool::Vertex* vertex) { return static_cast<std::size_t>(Util::hash(vertex, sizeof(MeshPool::Vertex))); };
+		auto equal = [](const MeshPool::Vertex* a, const MeshPool::Vertex* b) { return std::memcmp(a, b, sizeof(MeshPool::Vertex)) == 0; };
+		std::unordered_map<const MeshPool::Vertex*, MeshPool::Index, decltype(hash), decltype(equal)> unique(vertex_count, hash, equal);
+
+		IndexedMesh mesh;
+		mesh.vertices.reserve(vertex_count);
+
+		auto weld_vertex = [&](MeshPool::Index source) {
+			MeshPool::Index& target = remap[source];
+			if (target == UNSEEN) {
+				auto [it, inserted] = unique.emplace(&vertices[source], static_cast<MeshPool::Index>(mesh.vertices.size()));
+				if (inserted) {
+					mesh.vertices.push_back(vertices[source]);
+				}
+				target = it->second;
+			}
+			return target;
+		};
+
+		if (indices != nullptr) {
+			mesh.indices.reserve(index_count);
+			for (std::uint32_t i = 0u; i < index_count; ++i) {
+				mesh.indices.push_back(weld_vertex(indices[i]));
+			}
+		} else {
+			mesh.indices.reserve(vertex_count);
+			for (std::uint32_t i = 0u; i < vertex_count; ++i) {
+				mesh.indices.push_back(weld_vertex(i));
+			}
+		}
+
+		return mesh;
+	}
+
+	PackedMesh MeshUtil::pack(const IndexedMesh& mesh, const glm::vec3* normals, const glm::vec2* uvs, const glm::vec4* colors)
+	{
+		static_assert(sizeof(MeshPool::Vertex) == sizeof(glm::vec3), "Positions are read as a plain array");
+
+		PackedMesh packed;
+		packed.indices = mesh.indices;
+		packed.quantization = VertexPacking::fit(reinterpret_cast<const glm::vec3*>(mesh.vertices.data()), mesh.vertices.size());
+
+		packed.vertices.reserve(mesh.vertices.size());
+		for (std::size_t i = 0u; i < mesh.vertices.size(); ++i) {
+			PackedVertex vertex;
+			vertex.position = VertexPacking::quantize(mesh.vertices[i].position, packed.quantization);
+			vertex.normal = VertexPacking::encode_normal(normals != nullptr ? normals[i] : glm::vec3{ 0.0f, 0.0f, 1.0f });
+			vertex.uv = VertexPacking::encode_uv(uvs != nullptr ? uvs[i] : glm::vec2{ 0.0f });
+			vertex.color = VertexPacking::encode_color(colors != nullptr ? colors[i] : glm::vec4{ 1.0f });
+			packed.vertices.push_back(vertex);
+		}
+
+		return packed;
+	}
+
+} // namespace coral
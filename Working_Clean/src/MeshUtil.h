@@ -0,0 +1,36 @@
+#pragma once
+
+#include "MeshPool.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace coral {
+
+	/// Vertices and indices of one mesh, built on the CPU before uploading to a MeshPool.
+	struct IndexedMesh {
+		std::vector<MeshPool::Vertex> vertices{};
+		std::vector<MeshPool::Index> indices{};
+	};
+
+	/// Compressed mesh for a MeshPool of PackedVertex.
+	struct PackedMesh {
+		std::vector<PackedVertex> vertices{};
+		std::vector<MeshPool::Index> indices{};
+		PositionQuantization quantization{};
+	};
+
+	class MeshUtil {
+	public:
+
+		/// Merge bit-identical vertices using a hash table, rewriting the indices to match. Without input indices
+		/// the vertices are read in order, e.g. a triangle soup or strip. The vertex order of first use is kept.
+		[[nodiscard]] static IndexedMesh weld(const MeshPool::Vertex* vertices, std::uint32_t vertex_count, const MeshPool::Index* indices = nullptr, std::uint32_t index_count = 0u);
+
+		/// Compress a mesh, quantizing positions to its bounds. The other attributes have one entry per vertex
+		/// and may be null, defaulting to +z normals, zero UVs and white.
+		[[nodiscard]] static PackedMesh pack(const IndexedMesh& mesh, const glm::vec3* normals = nullptr, const glm::vec2* uvs = nullptr, const glm::vec4* colors = nullptr);
+
+	};
+
+} // namespace coral
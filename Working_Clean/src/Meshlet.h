@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+
+namespace coral {
+
+	/// A cluster of nearby triangles stored as a contiguous range of a mesh's indices, so it can be culled and
+	/// drawn on its own. Built by MeshletBuilder. Bounds are in object space.
+	///
+	/// The layout matches std430, so an array of meshlets can be uploaded as is for culling in a compute pass.
+	struct Meshlet {
+		/// Bounding sphere of the cluster's vertices.
+		glm::vec3 center;
+		float radius;
+		/// Backface cone: every triangle faces away from a camera for which the direction from the camera to
+		/// cone_apex is within the cone's angle of cone_axis.
+		glm::vec3 cone_apex;
+		/// Cosine of that angle. Greater than 1 when the triangles face too many ways to be culled together.
+		float cone_cutoff;
+		/// Average facing of the triangles, a unit vector.
+		glm::vec3 cone_axis;
+		/// Relative to the mesh's first index.
+		std::uint32_t first_index;
+		std::uint32_t index_count;
+		/// Distinct vertices referenced by the cluster.
+		std::uint32_t vertex_count;
+		/// Level of detail whose index range holds the cluster.
+		std::uint32_t lod;
+		/// Zero. Pads the struct to a multiple of 16 bytes.
+		std::uint32_t reserved;
+
+		/// Whether every triangle faces away from a perspective camera at camera_position, in object space.
+		[[nodiscard]] bool is_backfacing(const glm::vec3& camera_position) const noexcept
+		{
+			return glm::dot(glm::normalize(cone_apex - camera_position), cone_axis) >= cone_cutoff;
+		}
+
+		/// Whether every triangle faces away from an orthographic camera looking along a unit view direction.
+		[[nodiscard]] bool is_backfacing_along(const glm::vec3& view_direction) const noexcept
+		{
+			return glm::dot(view_direction, cone_axis) >= cone_cutoff;
+		}
+	};
+
+	static_assert(sizeof(Meshlet) == 64u, "Meshlet must match its std430 layout");
+
+} // namespace coral
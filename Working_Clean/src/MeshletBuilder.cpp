@@ -0,0 +1,285 @@
+#include "MeshletBuilder.h"
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace coral {
+
+	/// How much a candidate's distance from the cluster centre grows as its facing turns away from the cluster's.
+	static constexpr float CONE_WEIGHT = 2.0f;
+
+	/// Clusters whose triangles turn further than this from their average facing get no cone.
+	static constexpr float MIN_CONE_COSINE = 0.1f;
+
+	/// Cone cutoff that no view direction reaches.
+	static constexpr float NO_CONE = 2.0f;
+
+	/// Splits one range of a triangle list, appending the clusters in the order their triangles are written back.
+	static void build_range(IndexedMesh& mesh, std::uint32_t first_index, std::uint32_t index_count, std::uint32_t lod, std::vector<Meshlet>& meshlets)
+	{
+		const std::vector<MeshPool::Index> triangles(mesh.indices.begin() + first_index, mesh.indices.begin() + first_index + index_count);
+		std::size_t triangle_count = triangles.size() / 3u;
+		std::size_t vertex_count = mesh.vertices.size();
+
+		// Triangles around each vertex, and how many of them are still to be placed
+		std::vector<std::uint32_t> offsets(vertex_count + 1u, 0u);
+		for (MeshPool::Index index : triangles) {
+			++offsets[index + 1u];
+		}
+		for (std::size_t v = 0u; v < vertex_count; ++v) {
+			offsets[v + 1u] += offsets[v];
+		}
+		std::vector<std::uint32_t> remaining(vertex_count, 0u);
+		std::vector<std::uint32_t> adjacency(triangles.size());
+		for (std::size_t i = 0u; i < triangles.size(); ++i) {
+			MeshPool::Index v = triangles[i];
+			adjacency[offsets[v] + remaining[v]++] = static_cast<std::uint32_t>(i / 3u);
+		}
+
+		std::vector<glm::vec3> centroids(triangle_count);
+		std::vector<glm::vec3> normals(triangle_count);
+		for (std::size_t t = 0u; t < triangle_count; ++t) {
+			const glm::vec3& p0 = mesh.vertices[triangles[t * 3u]].position;
+			const glm::vec3& p1 = mesh.vertices[triangles[t * 3u + 1u]].position;
+			const glm::vec3& p2 = mesh.vertices[triangles[t * 3u + 2u]].position;
+			centroids[t] = (p0 + p1 + p2) / 3.0f;
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float length = glm::length(normal);
+			normals[t] = length > 0.0f ? normal / length : glm::vec3{ 0.0f };
+		}
+
+		std::vector<bool> placed(triangle_count, false);
+		std::vector<bool> in_cluster(vertex_count, false);
+		std::vector<MeshPool::Index> cluster_vertices;
+		std::vector<std::uint32_t> cluster_triangles;
+		glm::vec3 centroid_sum{ 0.0f };
+		glm::vec3 normal_sum{ 0.0f };
+
+		auto new_vertices = [&](std::uint32_t t) {
+			const MeshPool::Index* triangle = &triangles[t * 3u];
+			std::uint32_t count = 0u;
+			for (std::size_t k = 0u; k < 3u; ++k) {
+				bool repeated = (k > 0u && triangle[k] == triangle[0]) || (k > 1u && triangle[k] == triangle[1]);
+				if (!in_cluster[triangle[k]] && !repeated) {
+					++count;
+				}
+			}
+			return count;
+		};
+
+		auto add = [&](std::uint32_t t) {
+			for (std::size_t k = 0u; k < 3u; ++k) {
+				MeshPool::Index v = triangles[t * 3u + k];
+				if (!in_cluster[v]) {
+					in_cluster[v] = true;
+					cluster_vertices.push_back(v);
+				}
+				--remaining[v];
+			}
+			cluster_triangles.push_back(t);
+			placed[t] = true;
+			centroid_sum += centroids[t];
+			normal_sum += normals[t];
+		};
+
+		std::size_t write = first_index;
+		std::size_t seed_cursor = 0u;
+		std::uint32_t next_seed = std::numeric_limits<std::uint32_t>::max();
+		for (std::size_t placed_count = 0u; placed_count < triangle_count;) {
+			// Continue next to the previous cluster where possible, otherwise from the first unplaced triangle
+			if (next_seed == std::numeric_limits<std::uint32_t>::max()) {
+				while (placed[seed_cursor]) {
+					++seed_cursor;
+				}
+				next_seed = static_cast<std::uint32_t>(seed_cursor);
+			}
+			add(next_seed);
+
+			while (cluster_triangles.size() < MeshletBuilder::MAX_TRIANGLES) {
+				glm::vec3 center = centroid_sum / static_cast<float>(cluster_triangles.size());
+				float axis_length = glm::length(normal_sum);
+				glm::vec3 axis = axis_length > 0.0f ? normal_sum / axis_length : glm::vec3{ 0.0f };
+
+				std::uint32_t best = std::numeric_limits<std::uint32_t>::max();
+				std::uint32_t best_new = 0u;
+				float best_cost = 0.0f;
+				for (MeshPool::Index v : cluster_vertices) {
+					for (std::uint32_t i = offsets[v]; i < offsets[v + 1u]; ++i) {
+						std::uint32_t t = adjacency[i];
+						if (placed[t]) {
+							continue;
+						}
+						std::uint32_t added = new_vertices(t);
+						if (cluster_vertices.size() + added > MeshletBuilder::MAX_VERTICES) {
+							continue;
+						}
+						float cost = glm::distance(centroids[t], center) * (1.0f + CONE_WEIGHT * (1.0f - glm::dot(normals[t], axis)));
+						if (best == std::numeric_limits<std::uint32_t>::max() || added < best_new || (added == best_new && cost < best_cost)) {
+							best = t;
+							best_new = added;
+							best_cost = cost;
+						}
+					}
+				}
+				if (best == std::numeric_limits<std::uint32_t>::max()) {
+					break;
+				}
+				add(best);
+			}
+
+			// The next seed is the neighbouring triangle with the fewest unplaced neighbours, so corners are not left behind
+			next_seed = std::numeric_limits<std::uint32_t>::max();
+			std::uint32_t fewest = 0u;
+			for (MeshPool::Index v : cluster_vertices) {
+				for (std::uint32_t i = offsets[v]; i < offsets[v + 1u]; ++i) {
+					std::uint32_t t = adjacency[i];
+					if (placed[t]) {
+						continue;
+					}
+					const MeshPool::Index* triangle = &triangles[t * 3u];
+					std::uint32_t neighbours = remaining[triangle[0]] + remaining[triangle[1]] + remaining[triangle[2]];
+					if (next_seed == std::numeric_limits<std::uint32_t>::max() || neighbours < fewest) {
+						next_seed = t;
+						fewest = neighbours;
+					}
+				}
+			}
+
+			auto cluster_first = static_cast<std::uint32_t>(write);
+			for (std::uint32_t t : cluster_triangles) {
+				std::copy(triangles.begin() + t * 3u, triangles.begin() + t * 3u + 3u, mesh.indices.begin() + write);
+				write += 3u;
+			}
+			Meshlet meshlet = MeshletBuilder::compute_bounds(mesh, cluster_first, static_cast<std::uint32_t>(cluster_triangles.size() * 3u));
+			meshlet.lod = lod;
+			meshlets.push_back(meshlet);
+
+			placed_count += cluster_triangles.size();
+			for (MeshPool::Index v : cluster_vertices) {
+				in_cluster[v] = false;
+			}
+			cluster_vertices.clear();
+			cluster_triangles.clear();
+			centroid_sum = glm::vec3{ 0.0f };
+			normal_sum = glm::vec3{ 0.0f };
+		}
+	}
+
+	std::vector<Meshlet> MeshletBuilder::build(IndexedMesh& mesh)
+	{
+		return build(mesh, std::vector<LodLevel>{ LodLevel{ 0u, static_cast<std::uint32_t>(mesh.indices.size()), 0.0f } });
+	}
+
+	std::vector<Meshlet> MeshletBuilder::build(IndexedMesh& mesh, const std::vector<LodLevel>& lods)
+	{
+		if (mesh.indices.size() % 3u != 0u) {
+			throw std::invalid_argument("Only triangle lists can be split into meshlets");
+		}
+
+		std::vector<Meshlet> meshlets;
+		for (std::size_t i = 0u; i < lods.size(); ++i) {
+			const LodLevel& level = lods[i];
+			if (level.first_index > mesh.indices.size() || level.index_count > mesh.indices.size() - level.first_index || level.first_index % 3u != 0u
+				|| level.index_count % 3u != 0u) {
+				throw std::invalid_argument("Level of detail is not a range of whole triangles of the mesh");
+			}
+			build_range(mesh, level.first_index, level.index_count, static_cast<std::uint32_t>(i), meshlets);
+		}
+		return meshlets;
+	}
+
+	Meshlet MeshletBuilder::compute_bounds(const IndexedMesh& mesh, std::uint32_t first_index, std::uint32_t index_count)
+	{
+		Meshlet meshlet{};
+		meshlet.first_index = first_index;
+		meshlet.index_count = index_count;
+		meshlet.cone_cutoff = NO_CONE;
+		if (index_count == 0u) {
+			return meshlet;
+		}
+
+		const MeshPool::Index* indices = mesh.indices.data() + first_index;
+		std::vector<MeshPool::Index> vertices(indices, indices + index_count);
+		std::sort(vertices.begin(), vertices.end());
+		vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+		meshlet.vertex_count = static_cast<std::uint32_t>(vertices.size());
+
+		// Ritter's sphere: start from the most distant pair of axis extremes, then grow to take in every vertex
+		auto position = [&](MeshPool::Index v) -> const glm::vec3& { return mesh.vertices[v].position; };
+		MeshPool::Index min_vertex[3] = { vertices[0], vertices[0], vertices[0] };
+		MeshPool::Index max_vertex[3] = { vertices[0], vertices[0], vertices[0] };
+		for (MeshPool::Index v : vertices) {
+			for (int axis = 0; axis < 3; ++axis) {
+				if (position(v)[axis] < position(min_vertex[axis])[axis]) {
+					min_vertex[axis] = v;
+				}
+				if (position(v)[axis] > position(max_vertex[axis])[axis]) {
+					max_vertex[axis] = v;
+				}
+			}
+		}
+		int widest = 0;
+		for (int axis = 1; axis < 3; ++axis) {
+			if (glm::distance(position(min_vertex[axis]), position(max_vertex[axis])) > glm::distance(position(min_vertex[widest]), position(max_vertex[widest]))) {
+				widest = axis;
+			}
+		}
+		glm::vec3 center = (position(min_vertex[widest]) + position(max_vertex[widest])) * 0.5f;
+		float radius = glm::distance(position(min_vertex[widest]), position(max_vertex[widest])) * 0.5f;
+		for (MeshPool::Index v : vertices) {
+			float distance = glm::distance(center, position(v));
+			if (distance > radius) {
+				float grown = (radius + distance) * 0.5f;
+				center += (position(v) - center) * ((grown - radius) / distance);
+				radius = grown;
+			}
+		}
+		meshlet.center = center;
+		meshlet.radius = radius;
+
+		// Axis is the average facing; the cone holds every facing, and its apex lies behind every triangle's plane
+		struct Plane {
+			glm::vec3 point;
+			glm::vec3 normal;
+		};
+		std::vector<Plane> planes;
+		glm::vec3 normal_sum{ 0.0f };
+		for (std::uint32_t i = 0u; i < index_count; i += 3u) {
+			const glm::vec3& p0 = position(indices[i]);
+			glm::vec3 normal = glm::cross(position(indices[i + 1u]) - p0, position(indices[i + 2u]) - p0);
+			float length = glm::length(normal);
+			if (length > 0.0f) {
+				planes.push_back(Plane{ p0, normal / length });
+				normal_sum += normal / length;
+			}
+		}
+		meshlet.cone_apex = center;
+		float axis_length = glm::length(normal_sum);
+		if (axis_length == 0.0f) {
+			return meshlet;
+		}
+		glm::vec3 axis = normal_sum / axis_length;
+		meshlet.cone_axis = axis;
+
+		float min_cosine = 1.0f;
+		for (const Plane& plane : planes) {
+			min_cosine = std::min(min_cosine, glm::dot(plane.normal, axis));
+		}
+		if (min_cosine <= MIN_CONE_COSINE) {
+			return meshlet;
+		}
+
+		float apex_distance = 0.0f;
+		for (const Plane& plane : planes) {
+			apex_distance = std::max(apex_distance, glm::dot(center - plane.point, plane.normal) / glm::dot(axis, plane.normal));
+		}
+		meshlet.cone_apex = center - axis * apex_distance;
+		meshlet.cone_cutoff = std::sqrt(1.0f - min_cosine * min_cosine);
+		return meshlet;
+	}
+
+} // namespace coral
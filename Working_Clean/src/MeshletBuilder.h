@@ -0,0 +1,38 @@
+#pragma once
+
+#include "MeshLod.h"
+#include "Meshlet.h"
+#include "MeshUtil.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace coral {
+
+	/// Splits triangle lists into meshlets for culling below the level of whole models. No GL calls, so it runs
+	/// anywhere.
+	///
+	/// Clusters are grown greedily from a seed triangle, each step taking the neighbouring triangle that adds the
+	/// fewest new vertices, and among those the one closest to the cluster's centre and facing most like it, so
+	/// clusters come out round and flat enough for tight spheres and narrow backface cones. Triangles are moved
+	/// so each cluster is a contiguous range of indices; vertices are left as they are.
+	class MeshletBuilder {
+	public:
+
+		/// Limits of a cluster, chosen to fit mesh shader workgroups on common hardware.
+		static constexpr std::uint32_t MAX_VERTICES = 64u;
+		static constexpr std::uint32_t MAX_TRIANGLES = 124u;
+
+		/// Split a triangle list into meshlets, reordering its triangles in place.
+		[[nodiscard]] static std::vector<Meshlet> build(IndexedMesh& mesh);
+
+		/// Split each level of detail separately, e.g. those of a LodChain, so levels remain contiguous ranges.
+		/// Meshlets are returned ordered by level.
+		[[nodiscard]] static std::vector<Meshlet> build(IndexedMesh& mesh, const std::vector<LodLevel>& lods);
+
+		/// Bounding sphere and backface cone of a range of a triangle list.
+		[[nodiscard]] static Meshlet compute_bounds(const IndexedMesh& mesh, std::uint32_t first_index, std::uint32_t index_count);
+
+	};
+
+} // namespace coral
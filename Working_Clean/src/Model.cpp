@@ -1,46 +1,179 @@
 #include "Model.h"
 
-#include <string>
+#include "FrustumCuller.h"
+#include "IndirectBatch.h"
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshUtil.h"
+#include "StreamBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
 
 namespace coral {
 
-	struct AttributeIndex {
-		enum {
-			POSITION = 0,
-		};
-	};
+	Model::Model(MeshPool& pool, const Vertex* vertices, unsigned int count, GLenum mode)
+		: pool(&pool), mesh(pool.add(vertices, count)), mode(mode)
+	{
+	}
+
+	Model::Model(MeshPool& pool, IndexedMesh geometry, GLenum mode, bool optimize)
+		: pool(&pool), mode(mode)
+	{
+		// Only plain triangle lists can be freely reordered
+		if (optimize && mode == GL_TRIANGLES) {
+			MeshOptimizer::optimize(geometry);
+		}
+		mesh = pool.add(geometry.vertices.data(), static_cast<std::uint32_t>(geometry.vertices.size()), geometry.indices.data(), static_cast<std::uint32_t>(geometry.indices.size()));
+	}
 
-	Model::Model(const Vertex* vertices, unsigned int size, const char* label)
-		: vertex_count(size)
+	Model::Model(MeshPool& pool, const LodChain& chain)
+		: Model(pool, chain.mesh, GL_TRIANGLES, false)
 	{
-		glGenVertexArrays(1, &vao);
-		glBindVertexArray(vao);
-		glObjectLabel(GL_VERTEX_ARRAY, vao, -1, label);
+		set_lods(chain.levels);
+	}
 
-		glGenBuffers(1, &vbo);
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		glObjectLabel(GL_BUFFER, vbo, -1, (std::string(label) + ".VBO").c_str());
-		glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * size, vertices, GL_STATIC_DRAW);
+	Model::Model(MeshPool& pool, const PackedMesh& geometry, GLenum mode)
+		: pool(&pool),
+		mesh(pool.add(geometry.vertices.data(), static_cast<std::uint32_t>(geometry.vertices.size()), geometry.indices.data(), static_cast<std::uint32_t>(geometry.indices.size()),
+			geometry.quantization)),
+		mode(mode)
+	{
+	}
 
-		glEnableVertexAttribArray(AttributeIndex::POSITION);
-		glVertexAttribPointer(AttributeIndex::POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, position)));
+	Model::Model(MeshPool& pool, const MeshFile& file, GLenum mode)
+		: pool(&pool), mode(mode)
+	{
+		const MeshFileHeader& header = file.get_header();
+		if (MeshFile::get_vertex_format(pool.get_format()) != header.vertex_format) {
+			throw std::invalid_argument("Mesh file vertex format does not match the mesh pool's");
+		}
 
-		glBindBuffer(GL_ARRAY_BUFFER, NULL);
+		mesh = pool.add_dedicated(file.get_section(MeshSection::VERTICES), header.vertex_count, file.get_section(MeshSection::INDICES), header.index_count,
+			header.index_type, header.quantization);
 
-		glBindVertexArray(NULL);
+		const LodLevel* levels = file.get_lods();
+		lods.assign(levels, levels + header.lod_count);
+		const Meshlet* clusters = file.get_meshlets();
+		meshlets.assign(clusters, clusters + header.meshlet_count);
 	}
 
 	Model::~Model()
 	{
-		glDeleteBuffers(1, &vbo);
-		glDeleteVertexArrays(1, &vao);
+		if (pool != nullptr) {
+			pool->remove(mesh);
+		}
+	}
+
+	Model::Model(Model&& other) noexcept
+		: pool(std::exchange(other.pool, nullptr)), mesh(other.mesh), mode(other.mode), lods(std::move(other.lods)),
+		meshlets(std::move(other.meshlets))
+	{
+	}
+
+	Model& Model::operator=(Model&& other) noexcept
+	{
+		if (this != &other) {
+			if (pool != nullptr) {
+				pool->remove(mesh);
+			}
+			pool = std::exchange(other.pool, nullptr);
+			mesh = other.mesh;
+			mode = other.mode;
+			lods = std::move(other.lods);
+			meshlets = std::move(other.meshlets);
+		}
+		return *this;
+	}
+
+	void Model::draw(std::size_t lod) const
+	{
+		pool->draw(get_mesh(lod), mode);
 	}
 
-	void Model::draw() const noexcept
+	void Model::draw_instanced(StreamBuffer& stream, const Instance* instances, std::uint32_t count, std::size_t lod) const
 	{
-		glBindVertexArray(vao);
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, vertex_count);
-		glBindVertexArray(NULL);
+		if (count == 0u) {
+			return;
+		}
+
+		StreamBuffer::Allocation allocation = stream.allocate(sizeof(Instance) * count, alignof(Instance));
+		std::memcpy(allocation.data, instances, sizeof(Instance) * count);
+
+		pool->draw_instanced(get_mesh(lod), mode, stream.get_buffer(), allocation.offset, count);
+	}
+
+	void Model::set_lods(std::vector<LodLevel> levels)
+	{
+		for (const LodLevel& level : levels) {
+			if (level.first_index > mesh.index_count || level.index_count > mesh.index_count - level.first_index) {
+				throw std::invalid_argument("Level of detail lies outside the model's indices");
+			}
+		}
+		lods = std::move(levels);
+	}
+
+	void Model::set_meshlets(std::vector<Meshlet> clusters)
+	{
+		for (std::size_t i = 0u; i < clusters.size(); ++i) {
+			const Meshlet& meshlet = clusters[i];
+			if (meshlet.first_index > mesh.index_count || meshlet.index_count > mesh.index_count - meshlet.first_index) {
+				throw std::invalid_argument("Meshlet lies outside the model's indices");
+			}
+			if (i > 0u && meshlet.lod < clusters[i - 1u].lod) {
+				throw std::invalid_argument("Meshlets are not ordered by level of detail");
+			}
+			if (meshlet.lod >= get_lod_count() || meshlet.index_count % 3u != 0u) {
+				throw std::invalid_argument("Meshlet is not whole triangles of one of the model's levels of detail");
+			}
+		}
+		meshlets = std::move(clusters);
+	}
+
+	void Model::cull_meshlets(const Frustum& frustum, const glm::vec3& camera_position, std::size_t lod, std::vector<std::uint32_t>& visible) const
+	{
+		// Nothing would be appended, and the caller would draw nothing instead of the whole level
+		if (meshlets.empty()) {
+			throw std::invalid_argument("Model has no meshlets to cull");
+		}
+
+		// Levels past the last draw the last, as in get_mesh
+		auto level = static_cast<std::uint32_t>(std::min(lod, get_lod_count() - 1u));
+		auto first = std::lower_bound(meshlets.begin(), meshlets.end(), level, [](const Meshlet& meshlet, std::uint32_t lod) { return meshlet.lod < lod; });
+		auto last = std::upper_bound(first, meshlets.end(), level, [](std::uint32_t lod, const Meshlet& meshlet) { return lod < meshlet.lod; });
+		for (auto it = first; it != last; ++it) {
+			if (frustum.intersects_sphere(it->center, it->radius) && !it->is_backfacing(camera_position)) {
+				visible.push_back(static_cast<std::uint32_t>(it - meshlets.begin()));
+			}
+		}
+	}
+
+	void Model::add_meshlets(IndirectBatch& batch, const std::vector<std::uint32_t>& visible, std::uint32_t object_index) const
+	{
+		for (std::uint32_t index : visible) {
+			const Meshlet& meshlet = meshlets[index];
+			MeshPool::Mesh range = mesh;
+			range.first_index += meshlet.first_index;
+			range.index_count = meshlet.index_count;
+			batch.add(range, object_index);
+		}
+	}
+
+	MeshPool::Mesh Model::get_mesh(std::size_t lod) const noexcept
+	{
+		if (lods.empty()) {
+			return mesh;
+		}
+
+		// Levels share the vertices, so only the index range changes
+		const LodLevel& level = lods[std::min(lod, lods.size() - 1u)];
+		MeshPool::Mesh range = mesh;
+		range.first_index += level.first_index;
+		range.index_count = level.index_count;
+		return range;
 	}
 
 } // namespace coral
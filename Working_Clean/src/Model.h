@@ -1,37 +1,107 @@
 #pragma once
 
+#include "MeshLod.h"
+#include "MeshPool.h"
+#include "Meshlet.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 #include <glew/glew.h>
-#include <glm/vec3.hpp>
 
 namespace coral {
 
+	class IndirectBatch;
+	class MeshFile;
+	class StreamBuffer;
+	struct Frustum;
+	struct IndexedMesh;
+	struct LodChain;
+	struct PackedMesh;
+
+	/// A mesh stored in a MeshPool. Draw between MeshPool::bind and MeshPool::unbind.
+	///
+	/// A model may have levels of detail, ranges of its indices drawn in place of the whole list. Without any,
+	/// level 0 is the whole mesh. Each level may in turn be split into meshlets, which are culled and queued
+	/// one by one instead of drawing the level whole.
 	class Model {
 	public:
 
-		struct Vertex {
-			glm::vec3 position;
-		};
+		using Vertex = MeshPool::Vertex;
+		using Instance = MeshPool::Instance;
 
 	private:
 
-		GLuint vao = NULL;
-		GLuint vbo = NULL;
-		unsigned int vertex_count;
+		MeshPool* pool;
+		MeshPool::Mesh mesh;
+		GLenum mode;
+		std::vector<LodLevel> lods{};
+		/// Ordered by level of detail.
+		std::vector<Meshlet> meshlets{};
 
 	public:
 
-		Model(const Vertex* vertices, unsigned int count, const char* label);
+		/// Non-indexed geometry, drawn as the given primitive type.
+		Model(MeshPool& pool, const Vertex* vertices, unsigned int count, GLenum mode = GL_TRIANGLE_STRIP);
+
+		/// Indexed geometry, e.g. from MeshUtil::weld. The index width is chosen by the pool.
+		/// Triangle lists are run through MeshOptimizer first unless optimize is false.
+		Model(MeshPool& pool, IndexedMesh geometry, GLenum mode = GL_TRIANGLES, bool optimize = true);
+
+		/// Levels of detail from MeshSimplifier::build_lod_chain, uploaded as they are; the chain is already optimized.
+		Model(MeshPool& pool, const LodChain& chain);
+
+		/// Compressed geometry from MeshUtil::pack, for a pool of PackedVertex.
+		Model(MeshPool& pool, const PackedMesh& geometry, GLenum mode = GL_TRIANGLES);
+
+		/// Cooked geometry, uploaded straight from the mapped file into a page of its own, with its levels of detail
+		/// and meshlets.
+		/// The file's vertex format must match the pool's. The file may be closed afterwards.
+		Model(MeshPool& pool, const MeshFile& file, GLenum mode = GL_TRIANGLES);
 		~Model();
 
 		Model(const Model&) = delete;
 		Model& operator=(const Model&) = delete;
 
-		Model(Model&&) = default;
-		Model& operator=(Model&&) = default;
+		Model(Model&& other) noexcept;
+		Model& operator=(Model&& other) noexcept;
+
+		void draw(std::size_t lod = 0u) const;
 
-		void draw() const noexcept;
+		/// Draw many copies in one call. The instance data is copied into this frame's region of the stream.
+		void draw_instanced(StreamBuffer& stream, const Instance* instances, std::uint32_t count, std::size_t lod = 0u) const;
+
+		/// Use ranges of the uploaded indices as levels of detail, e.g. from a LodChain. Throws if a range lies
+		/// outside the mesh's indices.
+		void set_lods(std::vector<LodLevel> levels);
+
+		/// Use ranges of the uploaded indices as meshlets, e.g. from MeshletBuilder. Throws if a range lies outside
+		/// the mesh's indices or is not whole triangles, or the meshlets are not ordered by level of detail or name
+		/// a level the model does not have, so set the levels first.
+		void set_meshlets(std::vector<Meshlet> clusters);
+
+		/// Append the index in get_meshlets of every meshlet of a level whose sphere is not outside the frustum and
+		/// that is not facing away from a camera at camera_position. Both are in the model's object space, e.g.
+		/// Frustum::from_matrix of the view-projection times the model matrix. Throws if the model has no meshlets.
+		void cull_meshlets(const Frustum& frustum, const glm::vec3& camera_position, std::size_t lod, std::vector<std::uint32_t>& visible) const;
+
+		/// Queue a draw per meshlet, e.g. those left by cull_meshlets. Instances read object data from object_index.
+		void add_meshlets(IndirectBatch& batch, const std::vector<std::uint32_t>& visible, std::uint32_t object_index) const;
+
+		/// Level of detail to draw this frame, given the distance from the camera to the model's bounds.
+		[[nodiscard]] std::size_t select_lod(const LodSelector& selector, float distance, float scale = 1.0f) const noexcept
+		{
+			return selector.select(lods.data(), lods.size(), distance, scale);
+		}
+
+		/// The part of the pool drawn for a level of detail.
+		[[nodiscard]] MeshPool::Mesh get_mesh(std::size_t lod = 0u) const noexcept;
+		[[nodiscard]] GLenum get_mode() const noexcept { return mode; }
+		[[nodiscard]] std::size_t get_lod_count() const noexcept { return lods.empty() ? 1u : lods.size(); }
+		[[nodiscard]] const std::vector<LodLevel>& get_lods() const noexcept { return lods; }
+		[[nodiscard]] const std::vector<Meshlet>& get_meshlets() const noexcept { return meshlets; }
 
 	};
 
 } // namespace coral
-
@@ -0,0 +1,154 @@
+#include "ProgramBinaryCache.h"
+
+#include "Util.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace coral {
+
+	struct CacheHeader {
+		static constexpr std::uint32_t MAGIC = 0x43504243u; // "CPBC"
+		static constexpr std::uint32_t VERSION = 1u;
+
+		std::uint32_t magic;
+		std::uint32_t version;
+		std::uint64_t key;
+		std::uint32_t format;
+		std::uint32_t length;
+	};
+
+	ProgramBinaryCache::ProgramBinaryCache(const std::string& directory)
+		: directory(directory), driver_hash(Util::hash(nullptr, 0)), supported(false)
+	{
+		for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+			const char* value = reinterpret_cast<const char*>(glGetString(name));
+			if (value != nullptr) {
+				driver_hash = Util::hash(value, std::strlen(value) + 1, driver_hash);
+			}
+		}
+
+		GLint format_count = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+		supported = format_count > 0;
+
+		if (supported) {
+			std::error_code error;
+			std::filesystem::create_directories(directory, error);
+			supported = !error;
+		}
+	}
+
+	std::uint64_t ProgramBinaryCache::make_key(std::string_view vertex_source, std::string_view fragment_source, const char* label) const
+	{
+		// Mix in the lengths so the boundary between the sources is part of the key
+		std::uint64_t sizes[2] = { vertex_source.size(), fragment_source.size() };
+
+		std::uint64_t key = driver_hash;
+		key = Util::hash(sizes, sizeof(sizes), key);
+		key = Util::hash(vertex_source.data(), vertex_source.size(), key);
+		key = Util::hash(fragment_source.data(), fragment_source.size(), key);
+		key = Util::hash(label, std::strlen(label) + 1, key);
+		return key;
+	}
+
+	GLuint ProgramBinaryCache::load(std::uint64_t key, const char* label)
+	{
+		if (!supported) {
+			return 0u;
+		}
+
+		std::string path = get_path(key);
+		std::ifstream in(path, std::ios::binary);
+		if (!in.is_open()) {
+			++stats.misses;
+			return 0u;
+		}
+
+		CacheHeader header{};
+		std::vector<char> binary;
+		in.read(reinterpret_cast<char*>(&header), sizeof(header));
+		bool valid = in && header.magic == CacheHeader::MAGIC && header.version == CacheHeader::VERSION && header.key == key;
+		if (valid) {
+			// The binary fills the rest of the file, so a truncated or corrupt length is caught before allocating it
+			std::error_code error;
+			std::uintmax_t file_size = std::filesystem::file_size(path, error);
+			valid = !error && file_size - sizeof(header) == header.length;
+		}
+		if (valid) {
+			binary.resize(header.length);
+			in.read(binary.data(), header.length);
+			valid = static_cast<bool>(in);
+		}
+		in.close();
+
+		GLuint program = 0u;
+		if (valid) {
+			program = glCreateProgram();
+			glObjectLabel(GL_PROGRAM, program, -1, label);
+			glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+			GLint success = GL_FALSE;
+			glGetProgramiv(program, GL_LINK_STATUS, &success);
+			if (!success) {
+				glDeleteProgram(program);
+				program = 0u;
+			}
+		}
+
+		if (program == 0u) {
+			// Corrupt, or the driver no longer accepts this binary. Drop it so it is rebuilt.
+			++stats.stale;
+			std::remove(path.c_str());
+			return 0u;
+		}
+
+		++stats.hits;
+		return program;
+	}
+
+	void ProgramBinaryCache::store(std::uint64_t key, GLuint program)
+	{
+		if (!supported) {
+			return;
+		}
+
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0) {
+			return;
+		}
+
+		std::vector<char> binary(static_cast<std::size_t>(length));
+		GLenum format = 0;
+		glGetProgramBinary(program, length, &length, &format, binary.data());
+
+		CacheHeader header{ CacheHeader::MAGIC, CacheHeader::VERSION, key, format, static_cast<std::uint32_t>(length) };
+
+		std::ofstream out(get_path(key), std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(binary.data(), length);
+
+		if (out) {
+			++stats.stores;
+		}
+	}
+
+	void ProgramBinaryCache::print_stats() const
+	{
+		std::cout << "Program cache: " << stats.hits << " hits, " << stats.misses << " misses, "
+			<< stats.stale << " stale, " << stats.stores << " stored\n";
+	}
+
+	std::string ProgramBinaryCache::get_path(std::uint64_t key) const
+	{
+		char name[32];
+		std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+		return (std::filesystem::path(directory) / name).string();
+	}
+
+} // namespace coral
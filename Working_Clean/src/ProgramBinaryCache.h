@@ -0,0 +1,57 @@
+#pragma once
+
+#include <glew/glew.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace coral {
+
+	/// On-disk cache of linked program binaries retrieved with glGetProgramBinary.
+	/// Entries are keyed by the shader sources, the label and the driver identification strings, so a driver
+	/// update or a source edit naturally misses. Binaries the driver rejects are deleted and counted as stale.
+	class ProgramBinaryCache {
+	public:
+
+		struct Stats {
+			unsigned int hits = 0u;
+			unsigned int misses = 0u;
+			unsigned int stale = 0u;
+			unsigned int stores = 0u;
+		};
+
+	private:
+
+		std::string directory;
+		std::uint64_t driver_hash;
+		bool supported;
+		Stats stats{};
+
+	public:
+
+		/// Requires a current GL context.
+		explicit ProgramBinaryCache(const std::string& directory);
+
+		[[nodiscard]] std::uint64_t make_key(std::string_view vertex_source, std::string_view fragment_source, const char* label) const;
+
+		/// Create a program from a cached binary. Returns 0 on a miss or if the driver rejects the binary.
+		[[nodiscard]] GLuint load(std::uint64_t key, const char* label);
+
+		/// Save the binary of a successfully linked program, which should have been linked with
+		/// GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+		void store(std::uint64_t key, GLuint program);
+
+		[[nodiscard]] bool is_supported() const noexcept { return supported; }
+
+		[[nodiscard]] const Stats& get_stats() const noexcept { return stats; }
+
+		void print_stats() const;
+
+	private:
+
+		[[nodiscard]] std::string get_path(std::uint64_t key) const;
+
+	};
+
+} // namespace coral
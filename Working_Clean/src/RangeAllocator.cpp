@@ -0,0 +1,100 @@
+#include "RangeAllocator.h"
+
+#include <iterator>
+
+namespace coral {
+
+	RangeAllocator::RangeAllocator(Offset capacity)
+		: capacity(capacity), free_total(0u)
+	{
+		if (capacity > 0u) {
+			insert(0u, capacity);
+		}
+	}
+
+	RangeAllocator::Offset RangeAllocator::allocate(Offset size, Offset alignment)
+	{
+		if (size == 0u) {
+			return 0u;
+		}
+
+		// Best fit: the smallest free range that holds the request once aligned. Alignment padding only
+		// disqualifies ranges that are barely large enough, so this rarely looks past the first candidate.
+		for (auto it = free_by_size.lower_bound(size); it != free_by_size.end(); ++it) {
+			Offset range_size = it->first;
+			Offset range_offset = it->second;
+			Offset offset = (range_offset + alignment - 1u) / alignment * alignment;
+			Offset padding = offset - range_offset;
+			if (range_size - size < padding) {
+				continue;
+			}
+
+			free_by_size.erase(it);
+			free_by_offset.erase(range_offset);
+			free_total -= range_size;
+
+			if (padding > 0u) {
+				insert(range_offset, padding);
+			}
+			if (range_size > padding + size) {
+				insert(offset + size, range_size - padding - size);
+			}
+			return offset;
+		}
+		return INVALID_OFFSET;
+	}
+
+	void RangeAllocator::free(Offset offset, Offset size)
+	{
+		if (size == 0u) {
+			return;
+		}
+
+		// Merge with the free range that ends where this one starts
+		auto next = free_by_offset.lower_bound(offset);
+		if (next != free_by_offset.begin()) {
+			auto prev = std::prev(next);
+			if (prev->first + prev->second == offset) {
+				offset = prev->first;
+				size += prev->second;
+				erase_by_size(prev->first, prev->second);
+				free_total -= prev->second;
+				free_by_offset.erase(prev);
+			}
+		}
+
+		// And with the one that starts where this one ends
+		if (next != free_by_offset.end() && offset + size == next->first) {
+			size += next->second;
+			erase_by_size(next->first, next->second);
+			free_total -= next->second;
+			free_by_offset.erase(next);
+		}
+
+		insert(offset, size);
+	}
+
+	RangeAllocator::Offset RangeAllocator::get_largest_free() const noexcept
+	{
+		return free_by_size.empty() ? 0u : free_by_size.rbegin()->first;
+	}
+
+	void RangeAllocator::insert(Offset offset, Offset size)
+	{
+		free_by_offset.emplace(offset, size);
+		free_by_size.emplace(size, offset);
+		free_total += size;
+	}
+
+	void RangeAllocator::erase_by_size(Offset offset, Offset size)
+	{
+		auto [first, last] = free_by_size.equal_range(size);
+		for (auto it = first; it != last; ++it) {
+			if (it->second == offset) {
+				free_by_size.erase(it);
+				return;
+			}
+		}
+	}
+
+} // namespace coral
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+namespace coral {
+
+	/// Suballocates ranges out of a fixed capacity, e.g. elements of a GPU buffer.
+	/// Free ranges are indexed by size for best-fit allocation and by offset so neighbours merge when freed,
+	/// keeping both operations logarithmic in the number of free ranges.
+	class RangeAllocator {
+	public:
+
+		using Offset = std::uint32_t;
+
+		static constexpr Offset INVALID_OFFSET = ~Offset{ 0u };
+
+	private:
+
+		std::map<Offset, Offset> free_by_offset{};
+		std::multimap<Offset, Offset> free_by_size{};
+
+		Offset capacity;
+		Offset free_total;
+
+	public:
+
+		explicit RangeAllocator(Offset capacity);
+
+		/// Offset of a new range starting at a multiple of alignment, or INVALID_OFFSET if no free range is
+		/// large enough.
+		[[nodiscard]] Offset allocate(Offset size, Offset alignment = 1u);
+
+		/// Return a range previously allocated with the same size.
+		void free(Offset offset, Offset size);
+
+		[[nodiscard]] Offset get_capacity() const noexcept { return capacity; }
+		[[nodiscard]] Offset get_free() const noexcept { return free_total; }
+
+		/// Size of the largest range that can currently be allocated.
+		[[nodiscard]] Offset get_largest_free() const noexcept;
+
+		/// Number of disjoint free ranges. Higher means more fragmented.
+		[[nodiscard]] std::size_t get_free_range_count() const noexcept { return free_by_offset.size(); }
+
+	private:
+
+		void insert(Offset offset, Offset size);
+
+		void erase_by_size(Offset offset, Offset size);
+
+	};
+
+} // namespace coral
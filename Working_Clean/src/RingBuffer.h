@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace coral {
+
+	/// Fixed-size single producer ring buffer. The producer never blocks and overwrites the oldest entry once full.
+	/// Readers may run on another thread as long as they only look at fewer than CAPACITY recent entries,
+	/// which keeps them clear of the slot currently being written.
+	template<typename T, std::size_t CAPACITY>
+	class RingBuffer {
+
+		static_assert((CAPACITY & (CAPACITY - 1)) == 0, "Capacity must be a power of two");
+
+		std::array<T, CAPACITY> items{};
+		std::atomic<std::uint64_t> head{ 0u };
+
+	public:
+
+		void push(const T& item) noexcept
+		{
+			std::uint64_t index = head.load(std::memory_order_relaxed);
+			items[index & (CAPACITY - 1)] = item;
+			head.store(index + 1, std::memory_order_release);
+		}
+
+		/// Total number of items ever pushed.
+		[[nodiscard]] std::uint64_t get_count() const noexcept
+		{
+			return head.load(std::memory_order_acquire);
+		}
+
+		[[nodiscard]] std::size_t get_size() const noexcept
+		{
+			std::uint64_t count = get_count();
+			return count < CAPACITY ? static_cast<std::size_t>(count) : CAPACITY;
+		}
+
+		/// Access an item by age. Index 0 is the most recently pushed item.
+		[[nodiscard]] const T& recent(std::size_t age) const noexcept
+		{
+			return items[(get_count() - 1 - age) & (CAPACITY - 1)];
+		}
+
+		[[nodiscard]] static constexpr std::size_t get_capacity() noexcept { return CAPACITY; }
+
+	};
+
+} // namespace coral
@@ -0,0 +1,122 @@
+#include "ShaderCompiler.h"
+
+#include "ProgramBinaryCache.h"
+#include "ShaderUtil.h"
+
+namespace coral {
+
+	ShaderCompiler::ShaderCompiler(ProgramBinaryCache* cache)
+		: cache(cache), parallel(GLEW_KHR_parallel_shader_compile)
+	{
+		if (parallel) {
+			// Let the driver pick how many threads to use
+			glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+		}
+	}
+
+	ShaderCompiler::~ShaderCompiler()
+	{
+		for (auto& [handle, job] : jobs) {
+			glDeleteProgram(job.program);
+		}
+	}
+
+	ShaderCompiler::Handle ShaderCompiler::submit(const std::string& vertex_shader_path, const std::string& fragment_shader_path, const char* label)
+	{
+		const std::string& vertex_source = preprocessor.expand(vertex_shader_path);
+		const std::string& fragment_source = preprocessor.expand(fragment_shader_path);
+		return submit_source(vertex_source, fragment_source, label);
+	}
+
+	ShaderCompiler::Handle ShaderCompiler::submit_source(std::string_view vertex_source, std::string_view fragment_source, const char* label)
+	{
+		Job job;
+		if (cache != nullptr) {
+			job.key = cache->make_key(vertex_source, fragment_source, label);
+			job.program = cache->load(job.key, label);
+			if (job.program != 0u) {
+				job.state = State::READY;
+			}
+		}
+
+		if (job.program == 0u) {
+			job.program = ShaderUtil::begin_program(vertex_source, fragment_source, label, cache != nullptr);
+		}
+
+		Handle handle = next_handle++;
+		if (next_handle == INVALID_HANDLE) {
+			++next_handle;
+		}
+		jobs.emplace(handle, job);
+		return handle;
+	}
+
+	void ShaderCompiler::poll()
+	{
+		for (auto& [handle, job] : jobs) {
+			if (job.state != State::PENDING) {
+				continue;
+			}
+
+			if (parallel) {
+				GLint complete = GL_FALSE;
+				glGetProgramiv(job.program, GL_COMPLETION_STATUS_KHR, &complete);
+				if (complete) {
+					finish(job);
+				}
+			} else {
+				finish(job);
+				return;
+			}
+		}
+	}
+
+	void ShaderCompiler::wait(Handle handle)
+	{
+		auto it = jobs.find(handle);
+		if (it != jobs.end() && it->second.state == State::PENDING) {
+			finish(it->second);
+		}
+	}
+
+	ShaderCompiler::State ShaderCompiler::get_state(Handle handle) const
+	{
+		auto it = jobs.find(handle);
+		return it == jobs.end() ? State::UNKNOWN : it->second.state;
+	}
+
+	GLuint ShaderCompiler::take(Handle handle)
+	{
+		auto it = jobs.find(handle);
+		if (it == jobs.end() || it->second.state == State::PENDING) {
+			return 0u;
+		}
+
+		GLuint program = it->second.program;
+		jobs.erase(it);
+		return program;
+	}
+
+	void ShaderCompiler::cancel(Handle handle)
+	{
+		auto it = jobs.find(handle);
+		if (it != jobs.end()) {
+			glDeleteProgram(it->second.program);
+			jobs.erase(it);
+		}
+	}
+
+	void ShaderCompiler::finish(Job& job)
+	{
+		if (ShaderUtil::finish_program(job.program)) {
+			job.state = State::READY;
+			if (cache != nullptr) {
+				cache->store(job.key, job.program);
+			}
+		} else {
+			job.program = 0u;
+			job.state = State::FAILED;
+		}
+	}
+
+} // namespace coral
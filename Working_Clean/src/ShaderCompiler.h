@@ -0,0 +1,90 @@
+#pragma once
+
+#include "ShaderPreprocessor.h"
+
+#include <glew/glew.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace coral {
+
+	class ProgramBinaryCache;
+
+	/// Compiles programs without blocking the render thread.
+	/// Programs are submitted up front and become ready on later frames. With KHR_parallel_shader_compile the
+	/// driver compiles on its own threads and completion is polled with GL_COMPLETION_STATUS_KHR. Without it,
+	/// results are collected one program per poll so the cost is spread across frames.
+	class ShaderCompiler {
+	public:
+
+		using Handle = std::uint32_t;
+
+		static constexpr Handle INVALID_HANDLE = 0u;
+
+		enum class State {
+			PENDING,
+			READY,
+			FAILED,
+			UNKNOWN,
+		};
+
+	private:
+
+		struct Job {
+			GLuint program = 0u;
+			std::uint64_t key = 0u;
+			State state = State::PENDING;
+		};
+
+		ShaderPreprocessor preprocessor{};
+
+		std::unordered_map<Handle, Job> jobs{};
+		Handle next_handle = 1u;
+
+		ProgramBinaryCache* cache;
+		bool parallel;
+
+	public:
+
+		/// The cache is optional and must outlive the compiler.
+		explicit ShaderCompiler(ProgramBinaryCache* cache = nullptr);
+		~ShaderCompiler();
+
+		ShaderCompiler(const ShaderCompiler&) = delete;
+		ShaderCompiler& operator=(const ShaderCompiler&) = delete;
+
+		/// Start building a program from files, expanding includes through the preprocessor cache.
+		/// Cache hits are ready immediately.
+		[[nodiscard]] Handle submit(const std::string& vertex_shader_path, const std::string& fragment_shader_path, const char* label);
+
+		/// Start building a program from sources already in memory.
+		[[nodiscard]] Handle submit_source(std::string_view vertex_source, std::string_view fragment_source, const char* label);
+
+		/// Collect programs that have finished compiling.
+		void poll();
+
+		/// Block until the program has finished compiling.
+		void wait(Handle handle);
+
+		[[nodiscard]] State get_state(Handle handle) const;
+
+		/// Take ownership of a ready program and forget the handle. Returns 0 and forgets the handle if it failed.
+		[[nodiscard]] GLuint take(Handle handle);
+
+		/// Forget a handle in any state, deleting its program.
+		void cancel(Handle handle);
+
+		[[nodiscard]] bool is_parallel() const noexcept { return parallel; }
+
+		[[nodiscard]] ShaderPreprocessor& get_preprocessor() noexcept { return preprocessor; }
+
+	private:
+
+		void finish(Job& job);
+
+	};
+
+} // namespace coral
@@ -0,0 +1,228 @@
+#include "ShaderPreprocessor.h"
+
+#include "FileView.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <filesystem>
+
+namespace coral {
+
+	const std::string& ShaderPreprocessor::expand(const std::string& path)
+	{
+		std::string root = normalize(path);
+
+		auto it = expansions.find(root);
+		if (it != expansions.end() && is_current(it->second)) {
+			++stats.cache_hits;
+			return it->second.text;
+		}
+
+		Expansion expansion;
+		std::unordered_set<std::string> included;
+		std::vector<std::string> stack;
+		expand_file(root, expansion, included, stack);
+
+		++stats.expansions;
+		Expansion& stored = expansions[root];
+		stored = std::move(expansion);
+		return stored.text;
+	}
+
+	std::vector<std::string> ShaderPreprocessor::get_files(const std::string& path) const
+	{
+		std::vector<std::string> result;
+
+		auto it = expansions.find(normalize(path));
+		if (it != expansions.end()) {
+			for (const auto& [file, version] : it->second.files) {
+				result.push_back(file);
+			}
+		}
+		return result;
+	}
+
+	bool ShaderPreprocessor::update_file(const std::string& path, const std::string& contents)
+	{
+		std::string key = normalize(path);
+
+		auto it = files.find(key);
+		if (it != files.end() && it->second.hash == Util::hash(contents.data(), contents.size())) {
+			return false;
+		}
+
+		files[key] = parse(key, contents);
+		return true;
+	}
+
+	std::vector<std::string> ShaderPreprocessor::get_dependents(const std::string& path) const
+	{
+		std::string key = normalize(path);
+		std::vector<std::string> result;
+
+		for (const auto& [root, expansion] : expansions) {
+			auto depends = [&](const auto& file) { return file.first == key; };
+			if (std::any_of(expansion.files.begin(), expansion.files.end(), depends)) {
+				result.push_back(root);
+			}
+		}
+		return result;
+	}
+
+	void ShaderPreprocessor::clear()
+	{
+		files.clear();
+		expansions.clear();
+	}
+
+	std::string ShaderPreprocessor::normalize(const std::string& path)
+	{
+		return std::filesystem::path(path).lexically_normal().generic_string();
+	}
+
+	std::string ShaderPreprocessor::add_defines(const std::string& source, const std::vector<std::string>& defines)
+	{
+		if (defines.empty()) {
+			return source;
+		}
+
+		// Defines must follow #version, which has to come first
+		std::size_t insert = 0u;
+		std::size_t version = source.find("#version");
+		if (version != std::string::npos && (version == 0u || source[version - 1u] == '\n')) {
+			std::size_t end = source.find('\n', version);
+			insert = end == std::string::npos ? source.size() : end + 1u;
+		}
+
+		std::string result;
+		result.reserve(source.size() + defines.size() * 32u);
+		result.append(source, 0u, insert);
+		if (insert != 0u && result.back() != '\n') {
+			result += '\n';
+		}
+		auto next_line = std::count(result.begin(), result.end(), '\n') + 1;
+
+		for (const std::string& define : defines) {
+			result += "#define " + define + '\n';
+		}
+		result += "#line " + std::to_string(next_line) + " 0\n";
+		result.append(source, insert, std::string::npos);
+		return result;
+	}
+
+	const ShaderPreprocessor::File& ShaderPreprocessor::load(const std::string& path)
+	{
+		auto it = files.find(path);
+		if (it != files.end()) {
+			return it->second;
+		}
+
+		FileView view(path, FileAccess::SEQUENTIAL);
+		return files[path] = parse(path, std::string(view.get_view()));
+	}
+
+	ShaderPreprocessor::File ShaderPreprocessor::parse(const std::string& path, const std::string& contents)
+	{
+		static constexpr std::string_view DIRECTIVE = "#include";
+
+		++stats.files_parsed;
+
+		File file;
+		file.hash = Util::hash(contents.data(), contents.size());
+		file.version = next_version++;
+
+		std::filesystem::path directory = std::filesystem::path(path).parent_path();
+
+		std::size_t segment_start = 0;
+		std::size_t line_start = 0;
+		unsigned int line = 1;
+
+		while (line_start < contents.size()) {
+			std::size_t line_end = contents.find('\n', line_start);
+			if (line_end == std::string::npos) {
+				line_end = contents.size();
+			}
+
+			std::size_t first = contents.find_first_not_of(" \t", line_start);
+			if (first < line_end && contents.compare(first, DIRECTIVE.size(), DIRECTIVE) == 0) {
+				std::size_t open = contents.find('"', first + DIRECTIVE.size());
+				std::size_t close = (open < line_end) ? contents.find('"', open + 1) : std::string::npos;
+				if (close == std::string::npos || close > line_end) {
+					throw ShaderPreprocessException(path + "(" + std::to_string(line) + "): malformed #include");
+				}
+
+				std::string name = contents.substr(open + 1, close - open - 1);
+				file.segments.push_back(Segment{
+					contents.substr(segment_start, line_start - segment_start),
+					normalize((directory / name).string()),
+					line + 1,
+				});
+				segment_start = line_end + 1;
+			}
+
+			line_start = line_end + 1;
+			++line;
+		}
+
+		if (segment_start < contents.size()) {
+			file.segments.push_back(Segment{ contents.substr(segment_start), std::string(), 0u });
+		}
+
+		return file;
+	}
+
+	bool ShaderPreprocessor::is_current(const Expansion& expansion) const
+	{
+		for (const auto& [path, version] : expansion.files) {
+			auto it = files.find(path);
+			if (it == files.end() || it->second.version != version) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void ShaderPreprocessor::expand_file(const std::string& path, Expansion& expansion, std::unordered_set<std::string>& included, std::vector<std::string>& stack)
+	{
+		if (std::find(stack.begin(), stack.end(), path) != stack.end()) {
+			throw ShaderPreprocessException("Include cycle through " + path);
+		}
+		if (!included.insert(path).second) {
+			return;
+		}
+
+		const File* file;
+		try {
+			file = &load(path);
+		} catch (const ShaderPreprocessException&) {
+			throw;
+		} catch (const std::runtime_error&) {
+			std::string from = stack.empty() ? std::string() : " included from " + stack.back();
+			throw ShaderPreprocessException("Failed to open shader source " + path + from);
+		}
+
+		std::size_t index = expansion.files.size();
+		expansion.files.emplace_back(path, file->version);
+		stack.push_back(path);
+
+		for (const Segment& segment : file->segments) {
+			expansion.text += segment.text;
+			if (segment.include.empty()) {
+				continue;
+			}
+
+			if (included.count(segment.include) == 0) {
+				std::size_t child = expansion.files.size();
+				expansion.text += "#line 1 " + std::to_string(child) + '\n';
+				expand_file(segment.include, expansion, included, stack);
+				if (!expansion.text.empty() && expansion.text.back() != '\n') {
+					expansion.text += '\n';
+				}
+			}
+			expansion.text += "#line " + std::to_string(segment.next_line) + ' ' + std::to_string(index) + '\n';
+		}
+
+		stack.pop_back();
+	}
+
+} // namespace coral
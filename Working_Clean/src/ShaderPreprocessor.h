@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace coral {
+
+	class ShaderPreprocessException : public std::runtime_error {
+	public:
+		using std::runtime_error::runtime_error;
+	};
+
+	/// Resolves `#include "file"` directives in GLSL sources.
+	///
+	/// Every file is read and split at its include directives once, then kept until its contents change.
+	/// Expanded sources are cached per root file together with the version of every file in its include
+	/// graph, so re-expanding many programs after an edit only rebuilds the ones depending on that file.
+	/// Each file is included at most once per expansion, and `#line` directives keep compiler errors pointing
+	/// at the right file, using the index into get_files as the source string number.
+	class ShaderPreprocessor {
+	public:
+
+		struct Stats {
+			unsigned int files_parsed = 0u;
+			unsigned int expansions = 0u;
+			unsigned int cache_hits = 0u;
+		};
+
+	private:
+
+		struct Segment {
+			std::string text;
+			/// Normalized path of the file included after the text, or empty for the final segment.
+			std::string include;
+			/// Line in this file following the include directive.
+			unsigned int next_line;
+		};
+
+		struct File {
+			std::uint64_t hash = 0u;
+			std::uint64_t version = 0u;
+			std::vector<Segment> segments{};
+		};
+
+		struct Expansion {
+			std::string text;
+			/// Every file in the include graph, root first, with the version it was expanded from.
+			std::vector<std::pair<std::string, std::uint64_t>> files;
+		};
+
+		std::unordered_map<std::string, File> files{};
+		std::unordered_map<std::string, Expansion> expansions{};
+		std::uint64_t next_version = 1u;
+		Stats stats{};
+
+	public:
+
+		/// Expand a root shader file. The result stays valid until the next call that modifies the cache.
+		[[nodiscard]] const std::string& expand(const std::string& path);
+
+		/// Files the last expansion of a root depended on, root first. Empty if the root was never expanded.
+		[[nodiscard]] std::vector<std::string> get_files(const std::string& path) const;
+
+		/// Replace the cached contents of a file, e.g. with contents read by a file watcher.
+		/// Returns false if the contents are identical to what is already cached.
+		bool update_file(const std::string& path, const std::string& contents);
+
+		/// Root files whose last expansion includes the given file, directly or indirectly.
+		[[nodiscard]] std::vector<std::string> get_dependents(const std::string& path) const;
+
+		/// Drop everything so the next expansions read all files from disk again.
+		void clear();
+
+		[[nodiscard]] const Stats& get_stats() const noexcept { return stats; }
+
+		/// Normalized form of a path used as the cache key.
+		[[nodiscard]] static std::string normalize(const std::string& path);
+
+		/// Copy of an expanded source with `#define` lines inserted after its `#version` directive.
+		[[nodiscard]] static std::string add_defines(const std::string& source, const std::vector<std::string>& defines);
+
+	private:
+
+		const File& load(const std::string& path);
+
+		File parse(const std::string& path, const std::string& contents);
+
+		[[nodiscard]] bool is_current(const Expansion& expansion) const;
+
+		void expand_file(const std::string& path, Expansion& expansion, std::unordered_set<std::string>& included, std::vector<std::string>& stack);
+
+	};
+
+} // namespace coral
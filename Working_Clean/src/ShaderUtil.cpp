@@ -1,41 +1,81 @@
 #include "ShaderUtil.h"
 
-#include "Util.h"
+#include "ProgramBinaryCache.h"
+#include "ShaderPreprocessor.h"
 
-#include <sdl\SDL_video.h>
+#include <sdl/SDL_video.h>
 
 #include <iostream>
 
 namespace coral {
 
-	GLuint ShaderUtil::compile_shader(const std::string& vertex_shader_path, const std::string& fragment_shader_path, const char* label)
+	GLuint ShaderUtil::compile_shader(const std::string& vertex_shader_path, const std::string& fragment_shader_path, const char* label, ProgramBinaryCache* cache)
+	{
+		ShaderPreprocessor preprocessor;
+		const std::string& vertex_source = preprocessor.expand(vertex_shader_path);
+		const std::string& fragment_source = preprocessor.expand(fragment_shader_path);
+
+		std::uint64_t key = 0u;
+		if (cache != nullptr) {
+			key = cache->make_key(vertex_source, fragment_source, label);
+			GLuint program = cache->load(key, label);
+			if (program != 0u) {
+				return program;
+			}
+		}
+
+		GLuint program = begin_program(vertex_source, fragment_source, label, cache != nullptr);
+
+		if (!finish_program(program)) {
+			throw ShaderCompilationException{};
+		} else {
+			if (cache != nullptr) {
+				cache->store(key, program);
+			}
+			return program;
+		}
+	}
+
+	GLuint ShaderUtil::begin_program(std::string_view vertex_source, std::string_view fragment_source, const char* label, bool retrievable)
 	{
-		GLchar out_buf[1024];
 		const GLchar* src[1];
 		GLint length[1];
 
-		auto create = [&](const std::string& name, GLuint handle) {
-			std::string source = Util::read_file(name);
-
+		auto create = [&](std::string_view source, GLuint handle) {
 			src[0] = source.data();
-			length[0] = source.length();
+			length[0] = static_cast<GLint>(source.length());
 
 			glShaderSource(handle, 1, src, length);
 			glCompileShader(handle);
 		};
 
 		GLuint vertex_shader = glCreateShader(GL_VERTEX_SHADER);
-		create(vertex_shader_path, vertex_shader);
+		create(vertex_source, vertex_shader);
 
 		GLuint frag_shader = glCreateShader(GL_FRAGMENT_SHADER);
-		create(fragment_shader_path, frag_shader);
+		create(fragment_source, frag_shader);
 
 		GLuint program = glCreateProgram();
 		glObjectLabel(GL_PROGRAM, program, -1, label);
+		if (retrievable) {
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
 		glAttachShader(program, vertex_shader);
 		glAttachShader(program, frag_shader);
 
+		// Attached shaders live until they are detached or the program is deleted, so a program that is cancelled
+		// before finish_program still releases them
+		glDeleteShader(vertex_shader);
+		glDeleteShader(frag_shader);
+
 		glLinkProgram(program);
+
+		return program;
+	}
+
+	bool ShaderUtil::finish_program(GLuint program)
+	{
+		GLchar out_buf[1024];
 		glGetProgramInfoLog(program, sizeof(out_buf), nullptr, out_buf);
 
 		// Log info if not empty
@@ -43,22 +83,21 @@ namespace coral {
 			std::cout << "Program Info:\n" << out_buf;
 		}
 
-		glDetachShader(program, vertex_shader);
-		glDeleteShader(vertex_shader);
-
-		glDetachShader(program, frag_shader);
-		glDeleteShader(frag_shader);
+		GLuint shaders[2];
+		GLsizei shader_count = 0;
+		glGetAttachedShaders(program, 2, &shader_count, shaders);
+		for (GLsizei i = 0; i < shader_count; ++i) {
+			// Already flagged for deletion, so detaching frees them
+			glDetachShader(program, shaders[i]);
+		}
 
 		GLint success;
 		glGetProgramiv(program, GL_LINK_STATUS, &success);
-		glUseProgram(NULL);
 
 		if (!success) {
 			glDeleteProgram(program);
-			throw ShaderCompilationException{};
-		} else {
-			return program;
 		}
+		return success;
 	}
 
 } // namespace coral
\ No newline at end of file
@@ -4,15 +4,28 @@
 
 #include <exception>
 #include <string>
+#include <string_view>
 
 namespace coral {
 
 	class ShaderCompilationException : std::exception {};
 
+	class ProgramBinaryCache;
+
 	class ShaderUtil {
 	public:
 
-		[[nodiscard]] static GLuint compile_shader(const std::string& vertex_shader_path, const std::string& fragment_shader_path, const char* label);
+		/// Preprocess, compile and link a program. When a cache is given, a matching cached binary is used instead
+		/// and freshly linked programs are added to the cache.
+		[[nodiscard]] static GLuint compile_shader(const std::string& vertex_shader_path, const std::string& fragment_shader_path, const char* label, ProgramBinaryCache* cache = nullptr);
+
+		/// Submit compilation and linking of a program without waiting for the result.
+		/// The shaders stay attached until finish_program, and are freed with the program if it is deleted first.
+		[[nodiscard]] static GLuint begin_program(std::string_view vertex_source, std::string_view fragment_source, const char* label, bool retrievable);
+
+		/// Wait for linking to finish, log the info log and release the shaders. Deletes the program and
+		/// returns false if linking failed.
+		[[nodiscard]] static bool finish_program(GLuint program);
 
 	};
 
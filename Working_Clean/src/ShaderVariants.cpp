@@ -0,0 +1,223 @@
+#include "ShaderVariants.h"
+
+#include "ShaderPreprocessor.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace coral {
+
+	ShaderVariants::ShaderVariants(ShaderCompiler& compiler, std::string vertex_shader_path, std::string fragment_shader_path, std::string name, std::vector<std::string> features)
+		: compiler(compiler),
+		vertex_shader_path(std::move(vertex_shader_path)),
+		fragment_shader_path(std::move(fragment_shader_path)),
+		name(std::move(name)),
+		features(std::move(features))
+	{
+		if (this->features.size() > MAX_FEATURES) {
+			throw std::runtime_error("Too many shader features for a 64-bit variant key");
+		}
+	}
+
+	ShaderVariants::~ShaderVariants()
+	{
+		for (auto& [key, variant] : variants) {
+			compiler.cancel(variant.pending);
+			glDeleteProgram(variant.program);
+		}
+	}
+
+	ShaderVariants::Key ShaderVariants::make_key(std::initializer_list<std::string_view> defines) const
+	{
+		Key key = 0u;
+		for (std::string_view define : defines) {
+			auto it = std::find(features.begin(), features.end(), define);
+			if (it == features.end()) {
+				throw std::runtime_error("Unknown shader feature " + std::string(define));
+			}
+			key |= Key{ 1u } << (it - features.begin());
+		}
+		return key;
+	}
+
+	GLuint ShaderVariants::get(Key key)
+	{
+		Variant& variant = find_or_add(key);
+		variant.used = true;
+
+		if (variant.program == 0u && variant.pending == ShaderCompiler::INVALID_HANDLE && !variant.failed) {
+			submit(key, variant);
+		}
+		return variant.program;
+	}
+
+	void ShaderVariants::request(Key key)
+	{
+		Variant& variant = find_or_add(key);
+		if (variant.program == 0u && variant.pending == ShaderCompiler::INVALID_HANDLE && !variant.failed) {
+			submit(key, variant);
+		}
+	}
+
+	GLuint ShaderVariants::wait(Key key)
+	{
+		GLuint program = get(key);
+
+		ShaderCompiler::Handle pending = variants[key].pending;
+		if (pending != ShaderCompiler::INVALID_HANDLE) {
+			compiler.wait(pending);
+			poll();
+			program = variants[key].program;
+		}
+		return program;
+	}
+
+	unsigned int ShaderVariants::poll()
+	{
+		unsigned int finished = 0u;
+
+		for (auto& [key, variant] : variants) {
+			switch (compiler.get_state(variant.pending)) {
+				case ShaderCompiler::State::READY:
+					glDeleteProgram(variant.program);
+					variant.program = compiler.take(variant.pending);
+					break;
+
+				case ShaderCompiler::State::FAILED:
+					compiler.cancel(variant.pending);
+					variant.failed = true;
+
+					Util::set_color(AnsiColor::RED);
+					std::cout << "Shader variant " << variant.label << " failed to compile" << (variant.program == 0u ? "\n" : ", keeping previous program\n");
+					Util::clear_color();
+					break;
+
+				default:
+					continue;
+			}
+
+			variant.pending = ShaderCompiler::INVALID_HANDLE;
+			++finished;
+		}
+		return finished;
+	}
+
+	void ShaderVariants::reload()
+	{
+		for (auto& [key, variant] : variants) {
+			compiler.cancel(variant.pending);
+			variant.pending = ShaderCompiler::INVALID_HANDLE;
+			variant.failed = false;
+			submit(key, variant);
+		}
+	}
+
+	unsigned int ShaderVariants::prewarm(const std::string& usage_path)
+	{
+		std::ifstream file(usage_path);
+		if (!file) {
+			return 0u;
+		}
+
+		unsigned int count = 0u;
+		std::string line;
+		while (std::getline(file, line)) {
+			Key key = 0u;
+			bool known = true;
+
+			std::istringstream words(line);
+			std::string define;
+			while (words >> define) {
+				auto it = std::find(features.begin(), features.end(), define);
+				if (it == features.end()) {
+					known = false;
+					break;
+				}
+				key |= Key{ 1u } << (it - features.begin());
+			}
+
+			// Features may have been renamed since the list was recorded
+			if (!known) {
+				continue;
+			}
+
+			request(key);
+			++count;
+		}
+		return count;
+	}
+
+	void ShaderVariants::save_usage(const std::string& usage_path) const
+	{
+		std::ofstream file(usage_path, std::ios::trunc);
+		if (!file) {
+			return;
+		}
+
+		for (const auto& [key, variant] : variants) {
+			if (!variant.used) {
+				continue;
+			}
+
+			const char* separator = "";
+			for (const std::string& define : get_defines(key)) {
+				file << separator << define;
+				separator = " ";
+			}
+			file << '\n';
+		}
+	}
+
+	std::vector<std::string> ShaderVariants::get_defines(Key key) const
+	{
+		std::vector<std::string> defines;
+		for (std::size_t i = 0u; i < features.size(); ++i) {
+			if (key & (Key{ 1u } << i)) {
+				defines.push_back(features[i]);
+			}
+		}
+		return defines;
+	}
+
+	ShaderVariants::Variant& ShaderVariants::find_or_add(Key key)
+	{
+		auto it = variants.find(key);
+		if (it != variants.end()) {
+			return it->second;
+		}
+
+		Variant variant;
+		variant.label = name;
+		for (const std::string& define : get_defines(key)) {
+			variant.label += (variant.label.size() == name.size() ? "[" : " ") + define;
+		}
+		if (key != 0u) {
+			variant.label += ']';
+		}
+		return variants.emplace(key, std::move(variant)).first->second;
+	}
+
+	void ShaderVariants::submit(Key key, Variant& variant)
+	{
+		std::vector<std::string> defines = get_defines(key);
+
+		try {
+			ShaderPreprocessor& preprocessor = compiler.get_preprocessor();
+			std::string vertex_source = ShaderPreprocessor::add_defines(preprocessor.expand(vertex_shader_path), defines);
+			std::string fragment_source = ShaderPreprocessor::add_defines(preprocessor.expand(fragment_shader_path), defines);
+
+			variant.pending = compiler.submit_source(vertex_source, fragment_source, variant.label.c_str());
+		} catch (const std::exception& e) {
+			variant.failed = true;
+
+			Util::set_color(AnsiColor::RED);
+			std::cout << "Shader variant " << variant.label << " failed to load: " << e.what() << '\n';
+			Util::clear_color();
+		}
+	}
+
+} // namespace coral
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "ShaderCompiler.h"
+
+#include <glew/glew.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace coral {
+
+	/// Permutations of one vertex and fragment shader pair, selected by `#define` feature toggles.
+	///
+	/// Each feature is a bit in a 64-bit key. A variant is submitted to the compiler the first time its key is
+	/// requested and swapped in once ready, so unused combinations are never compiled. Keys requested during a
+	/// session can be saved and submitted up front next time to avoid hitches on first use.
+	class ShaderVariants {
+	public:
+
+		using Key = std::uint64_t;
+
+		static constexpr std::size_t MAX_FEATURES = 64u;
+
+	private:
+
+		struct Variant {
+			std::string label;
+			GLuint program = 0u;
+			ShaderCompiler::Handle pending = ShaderCompiler::INVALID_HANDLE;
+			bool failed = false;
+			bool used = false;
+		};
+
+		ShaderCompiler& compiler;
+		std::string vertex_shader_path;
+		std::string fragment_shader_path;
+		std::string name;
+		std::vector<std::string> features;
+
+		std::unordered_map<Key, Variant> variants{};
+
+	public:
+
+		/// The compiler must outlive the variants.
+		ShaderVariants(ShaderCompiler& compiler, std::string vertex_shader_path, std::string fragment_shader_path, std::string name, std::vector<std::string> features);
+		~ShaderVariants();
+
+		ShaderVariants(const ShaderVariants&) = delete;
+		ShaderVariants& operator=(const ShaderVariants&) = delete;
+
+		/// Key enabling the named features. Throws if a feature is unknown.
+		[[nodiscard]] Key make_key(std::initializer_list<std::string_view> defines) const;
+
+		/// Program for a variant, or 0 while it is compiling or if it failed. Submits the variant on first use.
+		[[nodiscard]] GLuint get(Key key);
+
+		/// Submit a variant without marking it as used.
+		void request(Key key);
+
+		/// Like get, but blocks until the variant has finished compiling.
+		GLuint wait(Key key);
+
+		/// Swap in variants the compiler has finished. Call after ShaderCompiler::poll.
+		/// Returns the number of variants that finished.
+		unsigned int poll();
+
+		/// Recompile every known variant after a source change. Current programs stay in use until replaced.
+		void reload();
+
+		/// Request every variant listed in a usage file. Returns the number of variants requested.
+		unsigned int prewarm(const std::string& usage_path);
+
+		/// Write the variants used this session, one line of features per variant.
+		void save_usage(const std::string& usage_path) const;
+
+		[[nodiscard]] const std::string& get_vertex_shader_path() const noexcept { return vertex_shader_path; }
+		[[nodiscard]] const std::string& get_fragment_shader_path() const noexcept { return fragment_shader_path; }
+		[[nodiscard]] std::size_t get_variant_count() const noexcept { return variants.size(); }
+
+		/// Feature names enabled by a key.
+		[[nodiscard]] std::vector<std::string> get_defines(Key key) const;
+
+	private:
+
+		Variant& find_or_add(Key key);
+
+		void submit(Key key, Variant& variant);
+
+	};
+
+} // namespace coral
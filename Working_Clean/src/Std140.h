@@ -0,0 +1,167 @@
+#pragma once
+
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+namespace coral {
+
+	namespace std140_detail {
+
+		constexpr std::size_t round_up(std::size_t value, std::size_t alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+	} // namespace std140_detail
+
+	/// Base alignment, size and encoding of a type under the std140 rules.
+	/// Specialized for the scalar, vector and matrix types used in uniform blocks.
+	template<typename T, typename = void>
+	struct Std140Type;
+
+	template<typename T>
+	struct Std140Type<T, std::enable_if_t<std::is_same_v<T, float> || std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::uint32_t>>> {
+		static constexpr std::size_t ALIGNMENT = 4;
+		static constexpr std::size_t SIZE = 4;
+
+		static void write(std::byte* dst, const T& value) noexcept { std::memcpy(dst, &value, SIZE); }
+	};
+
+	/// GLSL bool is a 32 bit value.
+	template<>
+	struct Std140Type<bool> {
+		static constexpr std::size_t ALIGNMENT = 4;
+		static constexpr std::size_t SIZE = 4;
+
+		static void write(std::byte* dst, bool value) noexcept
+		{
+			std::uint32_t word = value ? 1u : 0u;
+			std::memcpy(dst, &word, SIZE);
+		}
+	};
+
+	template<glm::length_t L, typename T, glm::qualifier Q>
+	struct Std140Type<glm::vec<L, T, Q>> {
+		static_assert(sizeof(T) == 4, "Only 32 bit vector components are supported");
+
+		/// A one component vector is laid out as its scalar; vec3 aligns like vec4 but only occupies 12 bytes.
+		static constexpr std::size_t ALIGNMENT = (L == 1) ? 4 : (L == 2) ? 8 : 16;
+		static constexpr std::size_t SIZE = L * 4;
+
+		static void write(std::byte* dst, const glm::vec<L, T, Q>& value) noexcept { std::memcpy(dst, &value, SIZE); }
+	};
+
+	/// Matrices are stored as arrays of column vectors, each column padded to vec4 alignment.
+	template<glm::length_t C, glm::length_t R, typename T, glm::qualifier Q>
+	struct Std140Type<glm::mat<C, R, T, Q>> {
+		static_assert(sizeof(T) == 4, "Only float matrices are supported");
+
+		static constexpr std::size_t COLUMN_STRIDE = 16;
+		static constexpr std::size_t ALIGNMENT = 16;
+		static constexpr std::size_t SIZE = C * COLUMN_STRIDE;
+
+		static void write(std::byte* dst, const glm::mat<C, R, T, Q>& value) noexcept
+		{
+			for (glm::length_t c = 0; c < C; ++c) {
+				std::memcpy(dst + c * COLUMN_STRIDE, &value[c], R * 4);
+			}
+		}
+	};
+
+	/// Array elements are padded out to a multiple of vec4.
+	template<typename T, std::size_t N>
+	struct Std140Type<std::array<T, N>> {
+		static constexpr std::size_t STRIDE = std140_detail::round_up(Std140Type<T>::SIZE, 16);
+		static constexpr std::size_t ALIGNMENT = std140_detail::round_up(Std140Type<T>::ALIGNMENT, 16);
+		static constexpr std::size_t SIZE = STRIDE * N;
+
+		static void write(std::byte* dst, const std::array<T, N>& value) noexcept
+		{
+			for (std::size_t i = 0; i < N; ++i) {
+				Std140Type<T>::write(dst + i * STRIDE, value[i]);
+			}
+		}
+	};
+
+	/// Compile-time std140 layout of a uniform block declared as an ordered list of member types.
+	/// Offsets, padding and size are computed by the compiler. Fields are addressed by index, usually
+	/// through an enum listing the members in declaration order.
+	///
+	/// The block is staged in an aligned byte array so it can be uploaded with a single memcpy.
+	template<typename... Fields>
+	class Std140Layout {
+
+		using FieldTuple = std::tuple<Fields...>;
+
+		static constexpr std::array<std::size_t, sizeof...(Fields)> compute_offsets()
+		{
+			std::array<std::size_t, sizeof...(Fields)> offsets{};
+			std::size_t sizes[] = { Std140Type<Fields>::SIZE... };
+			std::size_t alignments[] = { Std140Type<Fields>::ALIGNMENT... };
+
+			std::size_t offset = 0;
+			for (std::size_t i = 0; i < sizeof...(Fields); ++i) {
+				offset = std140_detail::round_up(offset, alignments[i]);
+				offsets[i] = offset;
+				offset += sizes[i];
+			}
+			return offsets;
+		}
+
+		static constexpr std::size_t compute_alignment()
+		{
+			std::size_t alignment = 4;
+			((alignment = Std140Type<Fields>::ALIGNMENT > alignment ? Std140Type<Fields>::ALIGNMENT : alignment), ...);
+			return alignment;
+		}
+
+	public:
+
+		static constexpr std::size_t FIELD_COUNT = sizeof...(Fields);
+		static constexpr std::array<std::size_t, FIELD_COUNT> OFFSETS = compute_offsets();
+		static constexpr std::size_t ALIGNMENT = compute_alignment();
+
+		/// Bytes used by the members, which is what GL_UNIFORM_BLOCK_DATA_SIZE reports for the block.
+		static constexpr std::size_t SIZE = OFFSETS[FIELD_COUNT - 1] + Std140Type<std::tuple_element_t<FIELD_COUNT - 1, FieldTuple>>::SIZE;
+
+		template<std::size_t I>
+		using FieldType = std::tuple_element_t<I, FieldTuple>;
+
+		template<std::size_t I>
+		static constexpr std::size_t OFFSET = OFFSETS[I];
+
+		class Block {
+
+			alignas(16) std::array<std::byte, SIZE> bytes{};
+
+		public:
+
+			template<std::size_t I>
+			void set(const FieldType<I>& value) noexcept
+			{
+				Std140Type<FieldType<I>>::write(bytes.data() + OFFSETS[I], value);
+			}
+
+			/// Copy the whole block into mapped buffer memory.
+			void write_to(void* dst) const noexcept
+			{
+				std::memcpy(dst, bytes.data(), SIZE);
+			}
+
+			[[nodiscard]] const std::byte* data() const noexcept { return bytes.data(); }
+
+		};
+
+	};
+
+} // namespace coral
@@ -0,0 +1,78 @@
+#include "StreamBuffer.h"
+
+#include "Util.h"
+
+#include <stdexcept>
+
+namespace coral {
+
+	StreamBuffer::StreamBuffer(GLsizeiptr region_size, const char* label)
+		: region_size(region_size)
+	{
+		static constexpr GLbitfield FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		// Bound to the copy target only to create it; users bind it wherever they read from it
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		glObjectLabel(GL_BUFFER, buffer, -1, label);
+		glBufferStorage(GL_COPY_WRITE_BUFFER, region_size * REGION_COUNT, nullptr, FLAGS);
+		mapped = static_cast<std::byte*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, region_size * REGION_COUNT, FLAGS));
+		glBindBuffer(GL_COPY_WRITE_BUFFER, NULL);
+
+		if (mapped == nullptr) {
+			glDeleteBuffers(1, &buffer);
+			Util::throw_exception("Failed to map stream buffer", label);
+		}
+	}
+
+	StreamBuffer::~StreamBuffer()
+	{
+		for (GLsync fence : fences) {
+			glDeleteSync(fence);
+		}
+
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, NULL);
+		glDeleteBuffers(1, &buffer);
+	}
+
+	void StreamBuffer::begin_frame()
+	{
+		region = (region + 1) % REGION_COUNT;
+		cursor = 0;
+
+		GLsync& fence = fences[region];
+		if (fence != nullptr) {
+			// Normally signaled long ago. Only blocks if the GPU is REGION_COUNT frames behind.
+			GLbitfield flags = 0;
+			while (glClientWaitSync(fence, flags, 1'000'000u) == GL_TIMEOUT_EXPIRED) {
+				flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+			}
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+
+	StreamBuffer::Allocation StreamBuffer::allocate(GLsizeiptr size, GLsizeiptr alignment)
+	{
+		GLsizeiptr start = (cursor + alignment - 1) / alignment * alignment;
+		if (start + size > region_size) {
+			throw std::runtime_error("Stream buffer region is full");
+		}
+		cursor = start + size;
+
+		GLintptr offset = region_size * region + start;
+		return Allocation{ mapped + offset, offset };
+	}
+
+	void StreamBuffer::end_frame()
+	{
+		GLsync& fence = fences[region];
+		if (fence != nullptr) {
+			glDeleteSync(fence);
+		}
+		fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+} // namespace coral
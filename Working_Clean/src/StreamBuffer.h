@@ -0,0 +1,60 @@
+#pragma once
+
+#include <glew/glew.h>
+
+#include <array>
+#include <cstddef>
+
+namespace coral {
+
+	/// Buffer for data written by the CPU every frame, such as per-instance attributes or indirect commands.
+	/// The buffer is persistently mapped and split into REGION_COUNT frame-sized regions. Each frame
+	/// suballocates linearly from the next region, and a fence per region guarantees a region is never
+	/// overwritten before the GPU is done with it.
+	class StreamBuffer {
+	public:
+
+		struct Allocation {
+			std::byte* data;
+			/// Offset from the start of the buffer, for binding or as an indirect/attribute offset.
+			GLintptr offset;
+		};
+
+	private:
+
+		static constexpr std::size_t REGION_COUNT = 3u;
+
+		GLuint buffer = 0u;
+		std::byte* mapped = nullptr;
+		GLsizeiptr region_size;
+
+		std::array<GLsync, REGION_COUNT> fences{};
+		std::size_t region = 0u;
+		GLsizeiptr cursor = 0;
+
+	public:
+
+		/// Room for region_size bytes per frame.
+		StreamBuffer(GLsizeiptr region_size, const char* label);
+		~StreamBuffer();
+
+		StreamBuffer(const StreamBuffer&) = delete;
+		StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+		/// Move to the next region, waiting only if the GPU is still reading it.
+		void begin_frame();
+
+		/// Reserve bytes in the current region. Throws if the region is full.
+		[[nodiscard]] Allocation allocate(GLsizeiptr size, GLsizeiptr alignment = 16);
+
+		/// Fence the current region. Call once all draws reading this frame's data have been submitted.
+		void end_frame();
+
+		[[nodiscard]] GLuint get_buffer() const noexcept { return buffer; }
+
+		/// Bytes still free in the current region.
+		[[nodiscard]] GLsizeiptr get_remaining() const noexcept { return region_size - cursor; }
+
+	};
+
+} // namespace coral
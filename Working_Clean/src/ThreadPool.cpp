@@ -0,0 +1,123 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace coral {
+
+	ThreadPool::ThreadPool(unsigned int thread_count)
+	{
+		if (thread_count == 0u) {
+			thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+		}
+
+		for (unsigned int i = 0u; i < thread_count; ++i) {
+			workers.emplace_back(&ThreadPool::run, this);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			running = false;
+		}
+		wake.notify_all();
+
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+
+	void ThreadPool::parallel_for(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& body)
+	{
+		if (count == 0u) {
+			return;
+		}
+
+		// A few ranges per thread evens out ranges that turn out slower than others
+		grain = std::max<std::size_t>(grain, 1u);
+		std::size_t range_count = std::min((count + grain - 1u) / grain, get_concurrency() * 4u);
+		std::size_t range_size = (count + range_count - 1u) / range_count;
+		range_count = (count + range_size - 1u) / range_size;
+
+		std::mutex done_mutex;
+		std::condition_variable done;
+		std::size_t remaining = range_count;
+		std::exception_ptr error;
+
+		auto run_range = [&](std::size_t range) {
+			std::size_t begin = range * range_size;
+			std::size_t end = std::min(begin + range_size, count);
+			try {
+				body(begin, end);
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(done_mutex);
+				if (!error) {
+					error = std::current_exception();
+				}
+			}
+
+			// Notify while holding the lock, so the caller cannot return and destroy done before this is finished with it
+			std::lock_guard<std::mutex> lock(done_mutex);
+			if (--remaining == 0u) {
+				done.notify_all();
+			}
+		};
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			for (std::size_t range = 1u; range < range_count; ++range) {
+				tasks.emplace_back([&run_range, range]() { run_range(range); });
+			}
+		}
+		wake.notify_all();
+
+		// Take the first range ourselves and help with the rest. Once none are left queued, the others are running
+		// on workers, so sleep until they finish.
+		run_range(0u);
+		while (run_one()) {
+		}
+		{
+			std::unique_lock<std::mutex> lock(done_mutex);
+			done.wait(lock, [&remaining]() { return remaining == 0u; });
+		}
+
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+	void ThreadPool::run()
+	{
+		while (true) {
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wake.wait(lock, [this]() { return !running || !tasks.empty(); });
+				if (!running && tasks.empty()) {
+					return;
+				}
+				task = std::move(tasks.front());
+				tasks.pop_front();
+			}
+			task();
+		}
+	}
+
+	bool ThreadPool::run_one()
+	{
+		std::function<void()> task;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (tasks.empty()) {
+				return false;
+			}
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		task();
+		return true;
+	}
+
+} // namespace coral
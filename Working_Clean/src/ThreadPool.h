@@ -0,0 +1,48 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace coral {
+
+	/// Fixed set of worker threads for splitting CPU work such as mesh import into parallel chunks.
+	/// The calling thread helps with its own work while waiting, so a pool of one thread still makes progress.
+	class ThreadPool {
+
+		std::mutex mutex{};
+		std::condition_variable wake{};
+		std::deque<std::function<void()>> tasks{};
+		bool running = true;
+		std::vector<std::thread> workers{};
+
+	public:
+
+		/// Zero picks one worker per hardware thread, less the caller's.
+		explicit ThreadPool(unsigned int thread_count = 0u);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/// Threads that run work, including the caller.
+		[[nodiscard]] std::size_t get_concurrency() const noexcept { return workers.size() + 1u; }
+
+		/// Call body(begin, end) over [0, count) in ranges of at least grain items, and wait for all of them.
+		/// The first exception thrown by a range is rethrown here once every range has finished.
+		void parallel_for(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& body);
+
+	private:
+
+		void run();
+
+		/// Run one queued task if there is one. Returns false if the queue was empty.
+		bool run_one();
+
+	};
+
+} // namespace coral
@@ -0,0 +1,77 @@
+#include "UniformBlockApplication.h"
+
+#include "Util.h"
+
+namespace coral {
+
+	UniformBlockApplication::UniformBlockApplication()
+	{
+		GLint alignment = 256;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		region_stride = (SIZE + alignment - 1) / alignment * alignment;
+
+		static constexpr GLbitfield FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glGenBuffers(1, &ubo);
+		glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+		glObjectLabel(GL_BUFFER, ubo, -1, "UBO::Application");
+		glBufferStorage(GL_UNIFORM_BUFFER, region_stride * REGION_COUNT, nullptr, FLAGS);
+		mapped = static_cast<std::byte*>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, region_stride * REGION_COUNT, FLAGS));
+		glBindBuffer(GL_UNIFORM_BUFFER, NULL);
+
+		if (mapped == nullptr) {
+			glDeleteBuffers(1, &ubo);
+			Util::throw_exception("Failed to map uniform buffer", "UBO::Application");
+		}
+	}
+
+	UniformBlockApplication::~UniformBlockApplication()
+	{
+		for (GLsync fence : fences) {
+			glDeleteSync(fence);
+		}
+
+		glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+		glUnmapBuffer(GL_UNIFORM_BUFFER);
+		glBindBuffer(GL_UNIFORM_BUFFER, NULL);
+		glDeleteBuffers(1, &ubo);
+	}
+
+	void UniformBlockApplication::bind() const
+	{
+		glBindBufferRange(GL_UNIFORM_BUFFER, BINDING, ubo, region_stride * region, SIZE);
+	}
+
+	void UniformBlockApplication::update(int win_width, int win_height, int mouse_x, int mouse_y, float ttime, float ctime)
+	{
+		region = (region + 1) % REGION_COUNT;
+
+		GLsync& fence = fences[region];
+		if (fence != nullptr) {
+			// Normally signaled long ago. Only blocks if the GPU is REGION_COUNT frames behind.
+			GLbitfield flags = 0;
+			while (glClientWaitSync(fence, flags, 1'000'000u) == GL_TIMEOUT_EXPIRED) {
+				flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+			}
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+
+		Layout::Block block;
+		block.set<WINDOW_SIZE>(glm::ivec2{ win_width, win_height });
+		block.set<MOUSE_POSITION>(glm::ivec2{ mouse_x, mouse_y });
+		block.set<TOTAL_TIME>(ttime);
+		block.set<CORRECTED_TIME>(ctime);
+		block.write_to(mapped + region_stride * region);
+	}
+
+	void UniformBlockApplication::end_frame()
+	{
+		GLsync& fence = fences[region];
+		if (fence != nullptr) {
+			glDeleteSync(fence);
+		}
+		fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+} // namespace coral
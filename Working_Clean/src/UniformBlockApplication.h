@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Std140.h"
+
+#include <glew/glew.h>
+#include <glm/vec2.hpp>
+
+#include <array>
+#include <cstddef>
+
+namespace coral {
+
+	/// Backing buffer for the ApplicationBlock uniform block shared by all shaders.
+	/// The buffer is persistently mapped and split into REGION_COUNT frame-sized regions. Each frame writes
+	/// the next region while the GPU may still read the previous ones, and a fence per region guarantees a
+	/// region is never overwritten before the GPU is done with it.
+	class UniformBlockApplication {
+
+		static constexpr unsigned int BINDING = 0u;
+
+		/// Mirrors ApplicationBlock in the shaders. Members must stay in declaration order.
+		using Layout = Std140Layout<
+			glm::ivec2, // window_size
+			glm::ivec2, // mouse_position
+			float,      // total_time
+			float       // corrected_time
+		>;
+
+		enum Field {
+			WINDOW_SIZE,
+			MOUSE_POSITION,
+			TOTAL_TIME,
+			CORRECTED_TIME,
+		};
+
+		static_assert(Layout::OFFSET<TOTAL_TIME> == 16 && Layout::OFFSET<CORRECTED_TIME> == 20 && Layout::SIZE == 24,
+			"Layout must match the offsets GL reports for ApplicationBlock");
+
+		static constexpr GLsizeiptr SIZE = Layout::SIZE;
+
+		static constexpr std::size_t REGION_COUNT = 3u;
+
+		GLuint ubo = 0u;
+		std::byte* mapped = nullptr;
+		GLsizeiptr region_stride = 0;
+
+		std::array<GLsync, REGION_COUNT> fences{};
+		std::size_t region = 0u;
+
+	public:
+
+		UniformBlockApplication();
+		~UniformBlockApplication();
+
+		UniformBlockApplication(const UniformBlockApplication&) = delete;
+		UniformBlockApplication& operator=(const UniformBlockApplication&) = delete;
+
+		/// Bind the region written by the last update.
+		void bind() const;
+
+		/// Move to the next region, waiting only if the GPU is still reading it, and write the values.
+		void update(int win_width, int win_height, int mouse_x, int mouse_y, float ttime, float ctime);
+
+		/// Fence the current region. Call once all draws using this frame's values have been submitted.
+		void end_frame();
+
+	};
+
+} // namespace coral
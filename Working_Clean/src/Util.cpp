@@ -2,25 +2,28 @@
 
 #include <iostream>
 #include <fstream>
+#include <stdexcept>
 
 namespace coral {
 
 	std::string Util::read_file(const std::string& filename)
 	{
-		std::ifstream in(filename);
+		std::ifstream in(filename, std::ios::binary);
 
 		if (!in.is_open()) {
 			static const std::string msg = "Failed to open file: ";
-			throw std::exception((msg + filename).c_str());
+			throw std::runtime_error((msg + filename).c_str());
 		}
 
+		// Size the string once and read straight into it instead of copying through stream iterators
 		std::string str;
 
 		in.seekg(0, std::ios::end);
-		str.reserve(static_cast<size_t>(in.tellg()));
+		str.resize(static_cast<size_t>(in.tellg()));
 		in.seekg(0, std::ios::beg);
 
-		str.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		in.read(str.data(), static_cast<std::streamsize>(str.size()));
+		str.resize(static_cast<size_t>(in.gcount()));
 
 		return str;
 	}
@@ -30,7 +33,41 @@ namespace coral {
 		std::string msg = message;
 		msg += '\n';
 		msg += details;
-		throw std::exception(msg.c_str());
+		throw std::runtime_error(msg.c_str());
+	}
+
+	std::uint64_t Util::hash(const void* data, std::size_t size, std::uint64_t seed) noexcept
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		std::uint64_t value = seed;
+		for (std::size_t i = 0; i < size; ++i) {
+			value ^= bytes[i];
+			value *= 1099511628211ull;
+		}
+		return value;
+	}
+
+	void Util::write_ppm(const std::string& filename, int width, int height, const std::uint8_t* rgba)
+	{
+		std::ofstream out(filename, std::ios::binary);
+
+		if (!out.is_open()) {
+			static const std::string msg = "Failed to open file: ";
+			throw std::runtime_error((msg + filename).c_str());
+		}
+
+		out << "P6\n" << width << ' ' << height << "\n255\n";
+
+		std::string row(static_cast<std::size_t>(width) * 3, '\0');
+		for (int y = height - 1; y >= 0; --y) {
+			const std::uint8_t* src = rgba + static_cast<std::size_t>(y) * width * 4;
+			for (int x = 0; x < width; ++x) {
+				row[x * 3 + 0] = static_cast<char>(src[x * 4 + 0]);
+				row[x * 3 + 1] = static_cast<char>(src[x * 4 + 1]);
+				row[x * 3 + 2] = static_cast<char>(src[x * 4 + 2]);
+			}
+			out.write(row.data(), row.size());
+		}
 	}
 
 	void Util::set_color(AnsiColor color)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <string>
 
@@ -15,12 +16,18 @@ namespace coral {
 	class Util {
 	public:
 
-		/// Read an entire file into a string.
+		/// Read an entire file into a string. Prefer FileView when the contents do not need to be owned.
 		[[nodiscard]] static std::string read_file(const std::string& filename);
 
 		/// Throw an exception with the given message.
 		static void throw_exception(const std::string& message, const char* details);
 
+		/// 64 bit FNV-1a, continuing from a previous hash value.
+		[[nodiscard]] static std::uint64_t hash(const void* data, std::size_t size, std::uint64_t seed = 14695981039346656037ull) noexcept;
+
+		/// Write bottom-up RGBA8 pixels, as returned by glReadPixels, to a binary PPM image.
+		static void write_ppm(const std::string& filename, int width, int height, const std::uint8_t* rgba);
+
 		static void set_color(AnsiColor color);
 
 		static void clear_color();
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Model.h"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+
+namespace coral {
+
+	struct VertexBank {
+
+		static constexpr std::array<Model::Vertex, 4> RECT = {
+			Model::Vertex{ // Top Left
+				glm::vec3{ -1.0f, +1.0f, 0.5f },
+			},
+			Model::Vertex{ // Bottom Left
+				glm::vec3{ -1.0f, -1.0f, 0.5f },
+			},
+			Model::Vertex{ // Top Right
+				glm::vec3{ +1.0f, +1.0f, 0.5f },
+			},
+			Model::Vertex{ // Bottom Right
+				glm::vec3{ +1.0f, -1.0f, 0.5f },
+			},
+		};
+
+		/// RECT as an indexed triangle list.
+		static constexpr std::array<MeshPool::Index, 6> RECT_INDICES = {
+			0u, 1u, 2u,
+			2u, 1u, 3u,
+		};
+
+	};
+
+} // namespace coral
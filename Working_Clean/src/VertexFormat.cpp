@@ -0,0 +1,115 @@
+#include "VertexFormat.h"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace coral {
+
+	VertexFormat::VertexFormat(const std::type_info& type, GLsizei stride, std::vector<VertexAttribute> attributes)
+		: type(&type), stride(stride), attributes(std::move(attributes))
+	{
+	}
+
+	void VertexFormat::apply(GLuint binding) const
+	{
+		for (const VertexAttribute& attribute : attributes) {
+			glEnableVertexAttribArray(attribute.location);
+			glVertexAttribFormat(attribute.location, attribute.size, attribute.type, attribute.normalized, attribute.offset);
+			glVertexAttribBinding(attribute.location, binding);
+		}
+	}
+
+	bool VertexFormat::has_quantized_position() const noexcept
+	{
+		for (const VertexAttribute& attribute : attributes) {
+			if (attribute.location == AttributeLocation::POSITION) {
+				return attribute.type == AttributeTraits<QuantizedPosition>::TYPE;
+			}
+		}
+		return false;
+	}
+
+	PositionQuantization VertexPacking::fit(const glm::vec3* positions, std::size_t count)
+	{
+		if (count == 0u) {
+			return PositionQuantization{};
+		}
+
+		glm::vec3 low = positions[0];
+		glm::vec3 high = positions[0];
+		for (std::size_t i = 1u; i < count; ++i) {
+			low = glm::min(low, positions[i]);
+			high = glm::max(high, positions[i]);
+		}
+
+		// Flat axes keep a nonzero scale so they still decode to their one value
+		PositionQuantization quantization;
+		quantization.offset = (low + high) * 0.5f;
+		quantization.scale = glm::max((high - low) * 0.5f, glm::vec3{ 1e-6f });
+		return quantization;
+	}
+
+	QuantizedPosition VertexPacking::quantize(const glm::vec3& position, const PositionQuantization& quantization)
+	{
+		glm::vec3 normalized = (position - quantization.offset) / quantization.scale;
+		return QuantizedPosition{ {
+			static_cast<std::int16_t>(glm::packSnorm1x16(normalized.x)),
+			static_cast<std::int16_t>(glm::packSnorm1x16(normalized.y)),
+			static_cast<std::int16_t>(glm::packSnorm1x16(normalized.z)),
+			0,
+		} };
+	}
+
+	glm::vec3 VertexPacking::dequantize(const QuantizedPosition& position, const PositionQuantization& quantization)
+	{
+		glm::vec3 normalized{
+			glm::unpackSnorm1x16(static_cast<std::uint16_t>(position.value[0])),
+			glm::unpackSnorm1x16(static_cast<std::uint16_t>(position.value[1])),
+			glm::unpackSnorm1x16(static_cast<std::uint16_t>(position.value[2])),
+		};
+		return normalized * quantization.scale + quantization.offset;
+	}
+
+	OctahedralNormal VertexPacking::encode_normal(const glm::vec3& normal)
+	{
+		// Project onto the octahedron |x| + |y| + |z| = 1, then fold the lower half over the upper
+		glm::vec3 n = normal / (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z));
+		glm::vec2 folded{ n.x, n.y };
+		if (n.z < 0.0f) {
+			folded.x = (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+			folded.y = (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+		}
+
+		return OctahedralNormal{ {
+			static_cast<std::int16_t>(glm::packSnorm1x16(folded.x)),
+			static_cast<std::int16_t>(glm::packSnorm1x16(folded.y)),
+		} };
+	}
+
+	glm::vec3 VertexPacking::decode_normal(const OctahedralNormal& normal)
+	{
+		// Mirrors decode_octahedral in packed.vert
+		glm::vec2 folded{ glm::unpackSnorm1x16(static_cast<std::uint16_t>(normal.value[0])), glm::unpackSnorm1x16(static_cast<std::uint16_t>(normal.value[1])) };
+		glm::vec3 n{ folded.x, folded.y, 1.0f - std::abs(folded.x) - std::abs(folded.y) };
+		float t = std::max(-n.z, 0.0f);
+		n.x += n.x >= 0.0f ? -t : t;
+		n.y += n.y >= 0.0f ? -t : t;
+		return glm::normalize(n);
+	}
+
+	HalfUV VertexPacking::encode_uv(const glm::vec2& uv)
+	{
+		return HalfUV{ { glm::packHalf1x16(uv.x), glm::packHalf1x16(uv.y) } };
+	}
+
+	Unorm8Color VertexPacking::encode_color(const glm::vec4& color)
+	{
+		return Unorm8Color{ { glm::packUnorm1x8(color.r), glm::packUnorm1x8(color.g), glm::packUnorm1x8(color.b), glm::packUnorm1x8(color.a) } };
+	}
+
+} // namespace coral
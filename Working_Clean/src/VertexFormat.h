@@ -0,0 +1,158 @@
+#pragma once
+
+#include <glew/glew.h>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <typeinfo>
+#include <vector>
+
+namespace coral {
+
+	/// Attribute locations shared by every vertex format and shader.
+	struct AttributeLocation {
+		enum : GLuint {
+			POSITION = 0,
+			/// A mat4 takes one location per column, up to INSTANCE_COLOR.
+			INSTANCE_TRANSFORM = 1,
+			INSTANCE_COLOR = 5,
+			INSTANCE_CUSTOM = 6,
+			NORMAL = 7,
+			UV = 8,
+			COLOR = 9,
+			/// Constant per draw. Quantized positions are position * scale + offset.
+			POSITION_SCALE = 10,
+			POSITION_OFFSET = 11,
+		};
+	};
+
+	/// xyz as snorm16 relative to the mesh's bounds, read as [-1, 1]. w pads the attribute to 8 bytes.
+	struct QuantizedPosition {
+		std::array<std::int16_t, 4> value;
+	};
+
+	/// Unit vector folded onto an octahedron and stored as two snorm16s. Decoded in the shader.
+	struct OctahedralNormal {
+		std::array<std::int16_t, 2> value;
+	};
+
+	/// Two half floats, read as a vec2.
+	struct HalfUV {
+		std::array<std::uint16_t, 2> value;
+	};
+
+	/// RGBA unorm8, read as a vec4.
+	struct Unorm8Color {
+		std::array<std::uint8_t, 4> value;
+	};
+
+	/// GL format of each attribute storage type.
+	template<typename T>
+	struct AttributeTraits;
+
+	template<> struct AttributeTraits<float> { static constexpr GLint SIZE = 1; static constexpr GLenum TYPE = GL_FLOAT; static constexpr GLboolean NORMALIZED = GL_FALSE; };
+	template<> struct AttributeTraits<glm::vec2> { static constexpr GLint SIZE = 2; static constexpr GLenum TYPE = GL_FLOAT; static constexpr GLboolean NORMALIZED = GL_FALSE; };
+	template<> struct AttributeTraits<glm::vec3> { static constexpr GLint SIZE = 3; static constexpr GLenum TYPE = GL_FLOAT; static constexpr GLboolean NORMALIZED = GL_FALSE; };
+	template<> struct AttributeTraits<glm::vec4> { static constexpr GLint SIZE = 4; static constexpr GLenum TYPE = GL_FLOAT; static constexpr GLboolean NORMALIZED = GL_FALSE; };
+	template<> struct AttributeTraits<QuantizedPosition> { static constexpr GLint SIZE = 4; static constexpr GLenum TYPE = GL_SHORT; static constexpr GLboolean NORMALIZED = GL_TRUE; };
+	template<> struct AttributeTraits<OctahedralNormal> { static constexpr GLint SIZE = 2; static constexpr GLenum TYPE = GL_SHORT; static constexpr GLboolean NORMALIZED = GL_TRUE; };
+	template<> struct AttributeTraits<HalfUV> { static constexpr GLint SIZE = 2; static constexpr GLenum TYPE = GL_HALF_FLOAT; static constexpr GLboolean NORMALIZED = GL_FALSE; };
+	template<> struct AttributeTraits<Unorm8Color> { static constexpr GLint SIZE = 4; static constexpr GLenum TYPE = GL_UNSIGNED_BYTE; static constexpr GLboolean NORMALIZED = GL_TRUE; };
+
+	struct VertexAttribute {
+		GLuint location;
+		GLint size;
+		GLenum type;
+		GLboolean normalized;
+		GLuint offset;
+	};
+
+	/// Describe a member of a vertex struct, taking its GL format from AttributeTraits.
+#define CORAL_VERTEX_ATTRIBUTE(Vertex, member, location) \
+	::coral::VertexAttribute{ location, ::coral::AttributeTraits<decltype(Vertex::member)>::SIZE, ::coral::AttributeTraits<decltype(Vertex::member)>::TYPE, \
+		::coral::AttributeTraits<decltype(Vertex::member)>::NORMALIZED, static_cast<GLuint>(offsetof(Vertex, member)) }
+
+	/// Specialize for each vertex struct with a static constexpr std::array ATTRIBUTES of CORAL_VERTEX_ATTRIBUTE.
+	template<typename Vertex>
+	struct VertexLayout;
+
+	/// Mesh-wide dequantization of QuantizedPosition.
+	struct PositionQuantization {
+		glm::vec3 scale{ 1.0f };
+		glm::vec3 offset{ 0.0f };
+	};
+
+	/// Runtime form of a VertexLayout, so that a MeshPool can hold any vertex struct.
+	class VertexFormat {
+
+		const std::type_info* type;
+		GLsizei stride;
+		std::vector<VertexAttribute> attributes;
+
+		VertexFormat(const std::type_info& type, GLsizei stride, std::vector<VertexAttribute> attributes);
+
+	public:
+
+		template<typename Vertex>
+		[[nodiscard]] static VertexFormat of()
+		{
+			const auto& layout = VertexLayout<Vertex>::ATTRIBUTES;
+			return VertexFormat(typeid(Vertex), sizeof(Vertex), std::vector<VertexAttribute>(layout.begin(), layout.end()));
+		}
+
+		/// Set up every attribute on the bound VAO, sourced from one buffer binding.
+		void apply(GLuint binding) const;
+
+		template<typename Vertex>
+		[[nodiscard]] bool is() const noexcept { return *type == typeid(Vertex); }
+
+		[[nodiscard]] GLsizei get_stride() const noexcept { return stride; }
+		[[nodiscard]] const std::vector<VertexAttribute>& get_attributes() const noexcept { return attributes; }
+
+		/// Whether positions are QuantizedPosition and need the mesh's PositionQuantization when drawn.
+		[[nodiscard]] bool has_quantized_position() const noexcept;
+
+	};
+
+	/// Compact vertex with every compressed attribute: 20 bytes, against 48 for the same attributes as floats.
+	struct PackedVertex {
+		QuantizedPosition position;
+		OctahedralNormal normal;
+		HalfUV uv;
+		Unorm8Color color;
+	};
+
+	template<>
+	struct VertexLayout<PackedVertex> {
+		static constexpr std::array<VertexAttribute, 4> ATTRIBUTES = {
+			CORAL_VERTEX_ATTRIBUTE(PackedVertex, position, AttributeLocation::POSITION),
+			CORAL_VERTEX_ATTRIBUTE(PackedVertex, normal, AttributeLocation::NORMAL),
+			CORAL_VERTEX_ATTRIBUTE(PackedVertex, uv, AttributeLocation::UV),
+			CORAL_VERTEX_ATTRIBUTE(PackedVertex, color, AttributeLocation::COLOR),
+		};
+	};
+
+	/// Conversions from float attributes to the compressed storage types.
+	class VertexPacking {
+	public:
+
+		/// Bounds of the positions, mapped to [-1, 1] on every axis.
+		[[nodiscard]] static PositionQuantization fit(const glm::vec3* positions, std::size_t count);
+
+		[[nodiscard]] static QuantizedPosition quantize(const glm::vec3& position, const PositionQuantization& quantization);
+		[[nodiscard]] static glm::vec3 dequantize(const QuantizedPosition& position, const PositionQuantization& quantization);
+
+		/// Normal need not be unit length, but must not be zero.
+		[[nodiscard]] static OctahedralNormal encode_normal(const glm::vec3& normal);
+		[[nodiscard]] static glm::vec3 decode_normal(const OctahedralNormal& normal);
+
+		[[nodiscard]] static HalfUV encode_uv(const glm::vec2& uv);
+		[[nodiscard]] static Unorm8Color encode_color(const glm::vec4& color);
+
+	};
+
+} // namespace coral
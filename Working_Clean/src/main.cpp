@@ -1,17 +1,46 @@
 #include "Util.h"
 
+#include "FileWatcher.h"
+#include "FixedTimestep.h"
+#include "FramePacer.h"
+#include "FrameStats.h"
+#include "Framebuffer.h"
+#include "FrustumCuller.h"
+#include "GpuProfiler.h"
+#include "HeadlessContext.h"
+#include "IndirectBatch.h"
+#include "MeshLod.h"
+#include "MeshPool.h"
+#include "MeshSimplifier.h"
+#include "MeshUtil.h"
+#include "ProgramBinaryCache.h"
+#include "ShaderCompiler.h"
+#include "ShaderPreprocessor.h"
 #include "ShaderUtil.h"
+#include "ShaderVariants.h"
+#include "StreamBuffer.h"
 #include "Model.h"
+#include "UniformBlockApplication.h"
+#include "VertexBank.h"
 
 #include <glew/glew.h>
+#include <glm/common.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 #include <glm/matrix.hpp>
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 #include <sdl/SDL.h>
 
 #include <array>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 using namespace coral;
 
@@ -24,130 +53,118 @@ static void GLAPIENTRY gl_message_callback(GLenum source, GLenum type, GLuint id
 	output << message << '\n';
 }
 
-class UniformBlockApplication {
-
-	static constexpr unsigned int BINDING = 0u;
-	static constexpr unsigned int SIZE =
-		4 * 2   // window_size
-		+ 4 * 2 // mouse_position
-		+ 4     // total_time
-		+ 4     // corrected_time
-		;
-
-	GLuint ubo;
-
-public:
-
-	UniformBlockApplication()
-	{
-		glGenBuffers(1, &ubo);
-		glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-		glObjectLabel(GL_BUFFER, ubo, -1, "UBO::Application");
-		glBufferStorage(GL_UNIFORM_BUFFER, SIZE, nullptr, GL_MAP_WRITE_BIT);
-		glBindBuffer(GL_UNIFORM_BUFFER, NULL);
-	}
-
-	~UniformBlockApplication()
-	{
-		glDeleteBuffers(1, &ubo);
-	}
+struct ProgramOptions {
+	/// Render offscreen without a window for a fixed number of frames using deterministic time.
+	bool headless = false;
+	unsigned int frame_count = 600u;
+	int width = 1280;
+	int height = 720;
+	/// Write the final frame to this PPM file in headless mode. Empty to skip.
+	std::string output_path{};
+};
 
-	UniformBlockApplication(const UniformBlockApplication&) = delete;
-	UniformBlockApplication& operator=(const UniformBlockApplication&) = delete;
+class Program {
 
-	UniformBlockApplication(UniformBlockApplication&&) = default;
-	UniformBlockApplication& operator=(UniformBlockApplication&&) = default;
+	static inline const std::string SHADER_PATH = "../Working_Clean/shaders/";
+	static inline const std::string SHADER_NAME = "first";
+	static inline const std::string SHADER_USAGE_PATH = "shader_usage.txt";
 
-	void bind() const
-	{
-		glBindBufferBase(GL_UNIFORM_BUFFER, BINDING, ubo);
-	}
+	/// Objects per side of the grid drawn in one indirect batch.
+	static constexpr std::uint32_t GRID_SIZE = 32u;
+	static constexpr GLuint OBJECT_BINDING = 1u;
 
-	void update(int win_width, int win_height, int mouse_x, int mouse_y, float ttime, float ctime)
-	{
-		glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-		std::byte* ptr = static_cast<std::byte*>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, SIZE, GL_MAP_WRITE_BIT));
+	/// Sprites drawn with one instanced call, their instance data streamed every frame.
+	static constexpr std::uint32_t SPRITE_COUNT = 16384u;
 
-		new(ptr) int(win_width);
-		new(ptr += 4) int(win_height);
+	/// Rings and segments of the sphere drawn from compressed vertices.
+	static constexpr std::uint32_t SPHERE_RINGS = 32u;
+	static constexpr std::uint32_t SPHERE_SEGMENTS = 64u;
 
-		new(ptr += 4) int(mouse_x);
-		new(ptr += 4) int(mouse_y);
+	/// Culling object indices: the main model, then one per grid object.
+	static constexpr std::uint32_t MODEL_OBJECT = 0u;
+	static constexpr std::uint32_t GRID_FIRST_OBJECT = 1u;
 
-		new(ptr += 4) float(ttime);
-		new(ptr += 4) float(ctime);
+	/// Mirrors ObjectData in batch.vert.
+	struct ObjectData {
+		glm::vec4 transform;
+		glm::vec4 color;
+	};
 
-		glUnmapBuffer(GL_UNIFORM_BUFFER);
-		glBindBuffer(GL_UNIFORM_BUFFER, NULL);
-	}
+	static constexpr unsigned int TICK_RATE = 120u;
+	static constexpr std::array<unsigned int, 5> TARGET_RATES = { 60u, 30u, 120u, 144u, FramePacer::UNCAPPED };
 
-};
+	FramePacer pacer{ TARGET_RATES[0] };
+	std::size_t target_rate_index = 0u;
+	float delta_time = 0.0f;
 
-struct VertexBank {
-
-	static constexpr std::array<Model::Vertex, 4> RECT = {
-		Model::Vertex{ // Top Left
-			glm::vec3{ -1.0f, +1.0f, 0.5f },
-		},
-		Model::Vertex{ // Bottom Left
-			glm::vec3{ -1.0f, -1.0f, 0.5f },
-		},
-		Model::Vertex{ // Top Right
-			glm::vec3{ +1.0f, +1.0f, 0.5f },
-		},
-		Model::Vertex{ // Bottom Right
-			glm::vec3{ +1.0f, -1.0f, 0.5f },
-		},
+	struct SimulationState {
+		float total_time = 0.0f;
+		float corrected_time = 0.0f;
 	};
 
-};
-
-class Program {
+	FixedTimestep timestep{ TICK_RATE };
+	SimulationState previous_state{};
+	SimulationState current_state{};
 
-	static constexpr unsigned int SWAP_DELAY = 1000u / 60u + 1;
+	FrameStats frame_stats{};
 
-	float total_time = 0.0f;
-	float corrected_time = 0.0f;
+	ProgramOptions options;
 
 	SDL_Window* window = nullptr;
 	SDL_GLContext context = nullptr;
+	std::unique_ptr<HeadlessContext> headless_context{};
+	std::unique_ptr<Framebuffer> framebuffer{};
 
-	GLuint program = 0u;
 	std::unique_ptr<UniformBlockApplication> ub_application{};
+	std::unique_ptr<MeshPool> mesh_pool{};
 	std::unique_ptr<Model> model{};
+	std::unique_ptr<IndirectBatch> batch{};
+	MeshPool::Mesh grid_mesh{};
+	GLuint object_buffer = 0u;
+	bool show_grid = false;
+	FrustumCuller culler{};
+	/// This frame's culling result, in ascending order.
+	FrustumCuller::IndexList visible_objects{};
+	std::unique_ptr<StreamBuffer> instance_stream{};
+	std::vector<Model::Instance> sprites{};
+	bool show_sprites = false;
+	std::unique_ptr<MeshPool> packed_pool{};
+	std::unique_ptr<Model> sphere{};
+	bool show_sphere = false;
+	/// Level drawn last frame, to report when selection switches.
+	std::size_t sphere_lod = 0u;
+	/// Height in pixels of the viewport as of the last uniform update, for level of detail selection.
+	int viewport_height = 0;
+	std::unique_ptr<GpuProfiler> gpu_profiler{};
+	std::unique_ptr<ProgramBinaryCache> program_cache{};
+	std::unique_ptr<ShaderCompiler> shader_compiler{};
+	std::unique_ptr<ShaderVariants> shader_variants{};
+	ShaderVariants::Key shader_key = 0u;
+	std::unique_ptr<ShaderVariants> batch_variants{};
+	std::unique_ptr<ShaderVariants> sprite_variants{};
+	std::unique_ptr<ShaderVariants> packed_variants{};
+	std::unique_ptr<FileWatcher> shader_watcher{};
 
 	bool quit = false;
-	bool skip_render = false;
 	SDL_Event cur_event{};
 
 	const Uint8* ScancodeMap = nullptr;
 
 public:
 
-	Program()
+	explicit Program(const ProgramOptions& options)
+		: options(options)
 	{
-		window = SDL_CreateWindow("SDL + OpenGL",
-			SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1280, 720,
-			SDL_WINDOW_RESIZABLE | SDL_WINDOW_OPENGL);
-		if (window == nullptr) {
-			throw std::exception(SDL_GetError());
-		}
-
-		static constexpr int CHANNEL_SIZE = 8;
-		SDL_GL_SetAttribute(SDL_GL_RED_SIZE, CHANNEL_SIZE);
-		SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, CHANNEL_SIZE);
-		SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, CHANNEL_SIZE);
-		SDL_GL_SetAttribute(SDL_GL_ALPHA_SIZE, CHANNEL_SIZE);
-		SDL_GL_SetAttribute(SDL_GL_BUFFER_SIZE, CHANNEL_SIZE * 4);
-		SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
-
-		context = SDL_GL_CreateContext(window);
-		if (context == nullptr) {
-			throw std::exception(SDL_GetError());
+		if (options.headless) {
+			headless_context.reset(new HeadlessContext());
+		} else {
+			create_window();
 		}
 
-		if (glewInit() != GLEW_OK) {
-			throw std::exception("GLEW failed to init");
+		// Without a display GLEW cannot reach GLX, but core entry points still resolve.
+		GLenum glew_status = glewInit();
+		if (glew_status != GLEW_OK && !(options.headless && glew_status == GLEW_ERROR_NO_GLX_DISPLAY)) {
+			throw std::runtime_error("GLEW failed to init");
 		}
 
 		glEnable(GL_DEBUG_OUTPUT);
@@ -156,21 +173,66 @@ public:
 
 		ScancodeMap = SDL_GetKeyboardState(nullptr);
 
-		create_buffers();
-		create_shader();
+		program_cache.reset(new ProgramBinaryCache("shader_cache"));
+		shader_compiler.reset(new ShaderCompiler(program_cache.get()));
+		shader_variants.reset(new ShaderVariants(*shader_compiler, SHADER_PATH + SHADER_NAME + ".vert", SHADER_PATH + SHADER_NAME + ".frag",
+			"Shader::Main", { "GRAYSCALE", "HIDE_CURSOR" }));
+		batch_variants.reset(new ShaderVariants(*shader_compiler, SHADER_PATH + "batch.vert", SHADER_PATH + "batch.frag", "Shader::Batch", {}));
+		sprite_variants.reset(new ShaderVariants(*shader_compiler, SHADER_PATH + "sprite.vert", SHADER_PATH + "sprite.frag", "Shader::Sprite", {}));
+		packed_variants.reset(new ShaderVariants(*shader_compiler, SHADER_PATH + "packed.vert", SHADER_PATH + "packed.frag", "Shader::Packed", {}));
+
+		if (options.headless) {
+			shader_variants->wait(shader_key);
+			program_cache->print_stats();
+		} else {
+			unsigned int prewarmed = shader_variants->prewarm(SHADER_USAGE_PATH);
+			if (prewarmed > 0u) {
+				std::cout << "Prewarming " << prewarmed << " shader variants from " << SHADER_USAGE_PATH << '\n';
+			}
+			shader_watcher.reset(new FileWatcher(SHADER_PATH));
+		}
 		ub_application.reset(new UniformBlockApplication());
-		model.reset(new Model(VertexBank::RECT.data(), VertexBank::RECT.size(), "Model::Main"));
-
-		// Force update to trigger viewport resize
-		SDL_SetWindowSize(window, 1280, 720);
+		mesh_pool.reset(new MeshPool(1u << 16, 1u << 18, "MeshPool::Main"));
+		model.reset(new Model(*mesh_pool, VertexBank::RECT.data(), VertexBank::RECT.size()));
+		create_buffers();
+		gpu_profiler.reset(new GpuProfiler());
+
+		if (options.headless) {
+			framebuffer.reset(new Framebuffer(options.width, options.height, "Framebuffer::Headless"));
+			framebuffer->bind();
+			glViewport(0, 0, options.width, options.height);
+		} else {
+			// Force update to trigger viewport resize
+			SDL_SetWindowSize(window, options.width, options.height);
+		}
 	}
 
 	~Program()
 	{
-		glDeleteProgram(program);
-
-		SDL_GL_DeleteContext(context);
-		SDL_DestroyWindow(window);
+		framebuffer.reset();
+		gpu_profiler.reset();
+		model.reset();
+		sphere.reset();
+		packed_pool.reset();
+		batch.reset();
+		instance_stream.reset();
+		glDeleteBuffers(1, &object_buffer);
+		mesh_pool.reset();
+		ub_application.reset();
+		if (!options.headless) {
+			shader_variants->save_usage(SHADER_USAGE_PATH);
+		}
+		shader_variants.reset();
+		batch_variants.reset();
+		sprite_variants.reset();
+		packed_variants.reset();
+		shader_compiler.reset();
+
+		headless_context.reset();
+		if (window != nullptr) {
+			SDL_GL_DeleteContext(context);
+			SDL_DestroyWindow(window);
+		}
 	}
 
 	void run()
@@ -178,45 +240,153 @@ public:
 		glPointSize(4.0f);
 		glPolygonMode(GL_BACK, GL_LINE);
 
+		pacer.reset();
+
+		unsigned int frame = 0u;
 		while (!quit) {
-			handle_events();
+			frame_stats.begin_frame();
+
+			if (options.headless) {
+				// Exactly one simulation step per frame keeps headless runs reproducible.
+				delta_time = timestep.get_step();
+				quit = ++frame >= options.frame_count;
+			} else {
+				handle_events();
+			}
+			frame_stats.mark(FramePhase::EVENTS);
+
+			watch_shaders();
+			poll_shader();
 
-			total_time += SWAP_DELAY / 1000.0f;
-			if (!ScancodeMap[SDL_SCANCODE_RSHIFT]) {
-				corrected_time += SWAP_DELAY / 1000.0f;
+			unsigned int steps = timestep.advance(delta_time);
+			for (unsigned int i = 0; i < steps; ++i) {
+				previous_state = current_state;
+				simulate(timestep.get_step());
 			}
+			frame_stats.mark(FramePhase::SIMULATE);
+
+			update_uniforms(timestep.get_alpha());
+			frame_stats.mark(FramePhase::UPDATE);
 
-			glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-			glClear(GL_COLOR_BUFFER_BIT);
+			gpu_profiler->begin_frame();
+			gpu_profiler->push_zone("Frame");
+			batch->begin_frame();
+			instance_stream->begin_frame();
 
-			update_uniforms();
+			{
+				GpuZone zone(*gpu_profiler, "Clear");
+				glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+				glClear(GL_COLOR_BUFFER_BIT);
+			}
+
+			// Every shader here draws straight to clip space, so the frustum is the clip volume itself
+			culler.cull(Frustum::from_matrix(glm::mat4{ 1.0f }), visible_objects);
 
-			if (!skip_render) {
+			GLuint program = shader_variants->get(shader_key);
+			if (program != 0u && !visible_objects.empty() && visible_objects[0] == MODEL_OBJECT) {
+				GpuZone zone(*gpu_profiler, "Model::Main");
 				glUseProgram(program);
 				ub_application->bind();
 
+				mesh_pool->bind();
 				model->draw();
+				mesh_pool->unbind();
 
 				glUseProgram(NULL);
 			}
 
-			SDL_GL_SwapWindow(window);
+			if (show_grid) {
+				draw_grid();
+			}
+			if (show_sprites) {
+				draw_sprites();
+			}
+			if (show_sphere) {
+				draw_sphere();
+			}
+			ub_application->end_frame();
+			batch->end_frame();
+			instance_stream->end_frame();
+
+			gpu_profiler->pop_zone();
+			gpu_profiler->end_frame();
+			frame_stats.mark(FramePhase::DRAW);
+
+			if (options.headless) {
+				glFinish();
+			} else {
+				SDL_GL_SwapWindow(window);
+			}
+			frame_stats.mark(FramePhase::SWAP);
+
+			frame_stats.end_frame();
 
-			SDL_Delay(SWAP_DELAY);
+			if (!options.headless) {
+				delta_time = pacer.wait();
+			}
+		}
+
+		if (options.headless) {
+			frame_stats.print();
+			gpu_profiler->print();
+
+			if (!options.output_path.empty()) {
+				std::vector<std::uint8_t> pixels = framebuffer->read_pixels();
+				Util::write_ppm(options.output_path, framebuffer->get_width(), framebuffer->get_height(), pixels.data());
+				std::cout << "Wrote final frame to " << options.output_path << '\n';
+			}
 		}
 	}
 
 private:
 
 
-	void update_uniforms()
+	void simulate(float step)
+	{
+		current_state.total_time += step;
+		if (!ScancodeMap[SDL_SCANCODE_RSHIFT]) {
+			current_state.corrected_time += step;
+		}
+	}
+
+	void create_window()
 	{
-		int mx, my;
-		SDL_GetMouseState(&mx, &my);
-		int width, height;
-		SDL_GetWindowSize(window, &width, &height);
+		window = SDL_CreateWindow("SDL + OpenGL",
+			SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, options.width, options.height,
+			SDL_WINDOW_RESIZABLE | SDL_WINDOW_OPENGL);
+		if (window == nullptr) {
+			throw std::runtime_error(SDL_GetError());
+		}
+
+		static constexpr int CHANNEL_SIZE = 8;
+		SDL_GL_SetAttribute(SDL_GL_RED_SIZE, CHANNEL_SIZE);
+		SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, CHANNEL_SIZE);
+		SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, CHANNEL_SIZE);
+		SDL_GL_SetAttribute(SDL_GL_ALPHA_SIZE, CHANNEL_SIZE);
+		SDL_GL_SetAttribute(SDL_GL_BUFFER_SIZE, CHANNEL_SIZE * 4);
+		SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+		context = SDL_GL_CreateContext(window);
+		if (context == nullptr) {
+			throw std::runtime_error(SDL_GetError());
+		}
+	}
+
+	void update_uniforms(float alpha)
+	{
+		auto lerp = [alpha](float a, float b) { return a + (b - a) * alpha; };
+		float total_time = lerp(previous_state.total_time, current_state.total_time);
+		float corrected_time = lerp(previous_state.corrected_time, current_state.corrected_time);
+
+		int mx = 0, my = 0;
+		int width = options.width, height = options.height;
+		if (!options.headless) {
+			SDL_GetMouseState(&mx, &my);
+			SDL_GetWindowSize(window, &width, &height);
+		}
 
 		ub_application->update(width, height, mx, height - my, total_time, corrected_time);
+		viewport_height = height;
 	}
 
 	void log_info()
@@ -264,38 +434,331 @@ private:
 		Util::print_divider("Info End");
 	}
 
+	void toggle_stats_recording()
+	{
+		static const std::string CSV_PATH = "frame_stats.csv";
+
+		if (frame_stats.is_recording()) {
+			frame_stats.close_csv();
+
+			Util::set_color(AnsiColor::GREEN);
+			std::cout << "Stopped recording frame stats to " << CSV_PATH << '\n';
+			Util::clear_color();
+			return;
+		}
+
+		// A locked or read-only file should not end the session
+		try {
+			frame_stats.open_csv(CSV_PATH);
+		} catch (const std::exception& e) {
+			Util::set_color(AnsiColor::RED);
+			std::cout << "Cannot record frame stats: " << e.what() << '\n';
+			Util::clear_color();
+			return;
+		}
+
+		Util::set_color(AnsiColor::GREEN);
+		std::cout << "Recording frame stats to " << CSV_PATH << '\n';
+		Util::clear_color();
+	}
+
+	void cycle_target_rate()
+	{
+		target_rate_index = (target_rate_index + 1) % TARGET_RATES.size();
+		pacer.set_target_rate(TARGET_RATES[target_rate_index]);
+
+		Util::set_color(AnsiColor::GREEN);
+		if (pacer.get_target_rate() == FramePacer::UNCAPPED) {
+			std::puts("Frame rate uncapped");
+		} else {
+			std::cout << "Frame rate capped to " << pacer.get_target_rate() << " Hz\n";
+		}
+		Util::clear_color();
+	}
+
+	void toggle_sprites()
+	{
+		show_sprites = !show_sprites;
+
+		Util::set_color(AnsiColor::GREEN);
+		std::cout << (show_sprites ? "Drawing " : "Hiding ") << SPRITE_COUNT << " sprites with one instanced call\n";
+		Util::clear_color();
+	}
+
+	void toggle_sphere()
+	{
+		show_sphere = !show_sphere;
+
+		Util::set_color(AnsiColor::GREEN);
+		std::cout << (show_sphere ? "Drawing " : "Hiding ") << "sphere from " << sizeof(PackedVertex) << "-byte compressed vertices with "
+			<< sphere->get_lod_count() << " levels of detail\n";
+		Util::clear_color();
+	}
+
+	void toggle_grid()
+	{
+		show_grid = !show_grid;
+
+		Util::set_color(AnsiColor::GREEN);
+		std::cout << (show_grid ? "Drawing " : "Hiding ") << GRID_SIZE * GRID_SIZE << " objects with one indirect batch\n";
+		Util::clear_color();
+	}
+
 	void create_buffers()
 	{
+		// A grid of small quads, drawn with a single multi-draw call when toggled on
+		grid_mesh = mesh_pool->add(VertexBank::RECT.data(), VertexBank::RECT.size(), VertexBank::RECT_INDICES.data(), VertexBank::RECT_INDICES.size());
+
+		std::vector<ObjectData> objects;
+		objects.reserve(GRID_SIZE * GRID_SIZE);
+		float cell = 2.0f / GRID_SIZE;
+		for (std::uint32_t y = 0u; y < GRID_SIZE; ++y) {
+			for (std::uint32_t x = 0u; x < GRID_SIZE; ++x) {
+				ObjectData object;
+				object.transform = glm::vec4{ -1.0f + cell * (x + 0.5f), -1.0f + cell * (y + 0.5f), cell * 0.4f, cell * 0.4f };
+				object.color = glm::vec4{ float(x) / GRID_SIZE, float(y) / GRID_SIZE, 0.5f, 1.0f };
+				objects.push_back(object);
+			}
+		}
+
+		glm::vec3 rect_min = VertexBank::RECT[0].position;
+		glm::vec3 rect_max = rect_min;
+		for (const Model::Vertex& vertex : VertexBank::RECT) {
+			rect_min = glm::min(rect_min, vertex.position);
+			rect_max = glm::max(rect_max, vertex.position);
+		}
+		culler.add(rect_min, rect_max);
+		for (const ObjectData& object : objects) {
+			glm::vec3 scale{ object.transform.z, object.transform.w, 1.0f };
+			glm::vec3 offset{ object.transform.x, object.transform.y, 0.0f };
+			culler.add(rect_min * scale + offset, rect_max * scale + offset);
+		}
+
+		glGenBuffers(1, &object_buffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, object_buffer);
+		glObjectLabel(GL_BUFFER, object_buffer, -1, "SSBO::Objects");
+		glBufferStorage(GL_SHADER_STORAGE_BUFFER, sizeof(ObjectData) * objects.size(), objects.data(), 0);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, NULL);
+
+		batch.reset(new IndirectBatch(GRID_SIZE * GRID_SIZE, "IndirectBatch::Main"));
+
+		instance_stream.reset(new StreamBuffer(sizeof(Model::Instance) * SPRITE_COUNT, "StreamBuffer::Instances"));
+		sprites.resize(SPRITE_COUNT);
+
+		create_sphere();
 	}
 
-	void create_shader()
+	/// A UV sphere with normals, UVs and colors, stored in a pool of compressed vertices.
+	void create_sphere()
 	{
-		static const std::string BASE_PATH = "../Working_Clean/shaders/";
+		static constexpr float RADIUS = 0.6f;
+
+		IndexedMesh mesh;
+		std::vector<glm::vec3> normals;
+		std::vector<glm::vec2> uvs;
+		std::vector<glm::vec4> colors;
+		for (std::uint32_t ring = 0u; ring <= SPHERE_RINGS; ++ring) {
+			float v = static_cast<float>(ring) / SPHERE_RINGS;
+			float polar = v * 3.14159265f;
+			for (std::uint32_t segment = 0u; segment <= SPHERE_SEGMENTS; ++segment) {
+				float u = static_cast<float>(segment) / SPHERE_SEGMENTS;
+				float azimuth = u * 6.28318531f;
+
+				glm::vec3 normal{ std::sin(polar) * std::sin(azimuth), std::cos(polar), std::sin(polar) * std::cos(azimuth) };
+				mesh.vertices.push_back(MeshPool::Vertex{ normal * RADIUS });
+				normals.push_back(normal);
+				uvs.push_back(glm::vec2{ u, v });
+				colors.push_back(glm::vec4{ 0.3f + 0.7f * u, 0.4f + 0.4f * v, 1.0f - 0.6f * u, 1.0f });
+			}
+		}
 
-		static const std::string FNAME = "first";
+		// Counter-clockwise seen from outside
+		static constexpr std::uint32_t ROW = SPHERE_SEGMENTS + 1u;
+		for (std::uint32_t ring = 0u; ring < SPHERE_RINGS; ++ring) {
+			for (std::uint32_t segment = 0u; segment < SPHERE_SEGMENTS; ++segment) {
+				MeshPool::Index a = ring * ROW + segment;
+				MeshPool::Index b = a + ROW;
+				mesh.indices.insert(mesh.indices.end(), { a, b, a + 1u, a + 1u, b, b + 1u });
+			}
+		}
 
-		Util::print_divider("Shader Compilation Begin");
+		// Levels of detail share the vertices, so the other attributes follow the simplifier's vertex order
+		std::vector<MeshPool::Index> sources;
+		LodChain chain = MeshSimplifier::build_lod_chain(mesh, LodSettings{}, &sources);
+		std::vector<glm::vec3> chain_normals;
+		std::vector<glm::vec2> chain_uvs;
+		std::vector<glm::vec4> chain_colors;
+		for (MeshPool::Index index : sources) {
+			chain_normals.push_back(normals[index]);
+			chain_uvs.push_back(uvs[index]);
+			chain_colors.push_back(colors[index]);
+		}
 
-		try {
-			program = ShaderUtil::compile_shader(
-				BASE_PATH + FNAME + ".vert",
-				BASE_PATH + FNAME + ".frag",
-				"Shader::Main");
+		packed_pool.reset(new MeshPool(VertexFormat::of<PackedVertex>(), 1u << 14, 1u << 16, "MeshPool::Packed"));
+		sphere.reset(new Model(*packed_pool, MeshUtil::pack(chain.mesh, chain_normals.data(), chain_uvs.data(), chain_colors.data())));
+		sphere->set_lods(std::move(chain.levels));
+	}
 
-			std::puts("Shader compiled successfully");
+	void draw_grid()
+	{
+		GLuint program = batch_variants->get(0u);
+		if (program == 0u) {
+			return;
+		}
 
-			skip_render = false;
-		} catch (const ShaderCompilationException&) {
-			program = NULL;
+		GpuZone zone(*gpu_profiler, "Grid::Batch");
+		glUseProgram(program);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, OBJECT_BINDING, object_buffer);
 
-			Util::set_color(AnsiColor::RED);
-			std::puts("Shader failed to compile");
-			Util::clear_color();
+		for (std::uint32_t object : visible_objects) {
+			if (object >= GRID_FIRST_OBJECT) {
+				batch->add(grid_mesh, object - GRID_FIRST_OBJECT);
+			}
+		}
+
+		mesh_pool->bind();
+		batch->submit(*mesh_pool, GL_TRIANGLES);
+		mesh_pool->unbind();
+
+		glUseProgram(NULL);
+	}
+
+	void draw_sprites()
+	{
+		GLuint program = sprite_variants->get(0u);
+		if (program == 0u) {
+			return;
+		}
+
+		// A slowly turning spiral; every instance moves, so the whole stream is rewritten each frame
+		static constexpr float GOLDEN_ANGLE = 2.39996323f;
+		float time = current_state.corrected_time;
+		for (std::uint32_t i = 0u; i < SPRITE_COUNT; ++i) {
+			float t = static_cast<float>(i) / SPRITE_COUNT;
+			float angle = GOLDEN_ANGLE * i + time * 0.25f;
+			float radius = 0.95f * std::sqrt(t);
+
+			Model::Instance& sprite = sprites[i];
+			// Each sprite also spins about its own centre
+			sprite.transform = glm::translate(glm::mat4{ 1.0f }, glm::vec3{ radius * std::cos(angle), radius * std::sin(angle), 0.0f });
+			sprite.transform = glm::rotate(sprite.transform, angle, glm::vec3{ 0.0f, 0.0f, 1.0f });
+			sprite.transform = glm::scale(sprite.transform, glm::vec3{ 0.004f, 0.004f, 1.0f });
+			sprite.color = glm::vec4{ 1.0f - t, 0.5f, t, 1.0f };
+			sprite.custom = glm::vec4{ 0.0f };
+		}
+
+		GpuZone zone(*gpu_profiler, "Sprites::Instanced");
+		glUseProgram(program);
+
+		mesh_pool->bind();
+		model->draw_instanced(*instance_stream, sprites.data(), SPRITE_COUNT);
+		mesh_pool->unbind();
+
+		glUseProgram(NULL);
+	}
+
+	void draw_sphere()
+	{
+		GLuint program = packed_variants->get(0u);
+		if (program == 0u) {
+			return;
+		}
+
+		GpuZone zone(*gpu_profiler, "Sphere::Packed");
+		glUseProgram(program);
+		ub_application->bind();
+		glEnable(GL_CULL_FACE);
+
+		// The sphere slowly shrinks and grows, coarsening as it covers fewer pixels. packed.vert draws object space
+		// straight to clip space, so two units span the viewport's height.
+		float scale = 0.55f + 0.45f * std::cos(current_state.corrected_time * 0.4f);
+		glUniform1f(0, scale);
+		std::size_t lod = sphere->select_lod(LodSelector::orthographic(2.0f, static_cast<float>(viewport_height)), 0.0f, scale);
+
+		if (lod != sphere_lod) {
+			sphere_lod = lod;
+			std::cout << "Sphere level of detail " << lod << ": " << sphere->get_mesh(lod).index_count / 3u << " triangles\n";
+		}
 
-			skip_render = true;
+		packed_pool->bind();
+		sphere->draw(lod);
+		packed_pool->unbind();
+
+		glDisable(GL_CULL_FACE);
+		glUseProgram(NULL);
+	}
+
+	void cycle_shader_variant()
+	{
+		// Walk through every combination of the main shader's features
+		shader_key = (shader_key + 1u) % (ShaderVariants::Key{ 1u } << 2u);
+
+		Util::set_color(AnsiColor::GREEN);
+		std::cout << "Shader variant:";
+		for (const std::string& define : shader_variants->get_defines(shader_key)) {
+			std::cout << ' ' << define;
+		}
+		std::cout << (shader_key == 0u ? " (base)\n" : "\n");
+		Util::clear_color();
+	}
+
+	/// Pick up shader edits saved to disk and recompile if the main shader depends on an edited file.
+	void watch_shaders()
+	{
+		if (!shader_watcher) {
+			return;
+		}
+
+		ShaderPreprocessor& preprocessor = shader_compiler->get_preprocessor();
+
+		std::vector<std::string> changed_roots;
+		for (const FileWatcher::Change& change : shader_watcher->take_changes()) {
+			// Editors save half-written files too. Keep the current programs until a save parses.
+			try {
+				if (!preprocessor.update_file(SHADER_PATH + change.name, change.contents)) {
+					continue; // Saved without modification
+				}
+			} catch (const std::exception& e) {
+				Util::set_color(AnsiColor::RED);
+				std::cout << "Shader " << change.name << " failed to parse, keeping previous programs: " << e.what() << '\n';
+				Util::clear_color();
+				continue;
+			}
+			for (std::string& root : preprocessor.get_dependents(SHADER_PATH + change.name)) {
+				changed_roots.push_back(std::move(root));
+			}
+		}
+
+		for (ShaderVariants* variants : { shader_variants.get(), batch_variants.get(), sprite_variants.get(), packed_variants.get() }) {
+			const std::string vertex_path = ShaderPreprocessor::normalize(variants->get_vertex_shader_path());
+			const std::string fragment_path = ShaderPreprocessor::normalize(variants->get_fragment_shader_path());
+
+			bool changed = false;
+			for (const std::string& root : changed_roots) {
+				changed |= root == vertex_path || root == fragment_path;
+			}
+
+			if (changed) {
+				Util::set_color(AnsiColor::GREEN);
+				std::cout << "Shader source changed, recompiling " << variants->get_variant_count() << " variants...\n";
+				Util::clear_color();
+
+				variants->reload();
+			}
 		}
+	}
+
+	/// Swap in shader variants once the driver has finished them. Previous programs keep rendering until then,
+	/// and stay in use if the new ones fail.
+	void poll_shader()
+	{
+		shader_compiler->poll();
 
-		Util::print_divider("Shader Compilation End");
+		unsigned int finished = shader_variants->poll() + batch_variants->poll() + sprite_variants->poll() + packed_variants->poll();
+		if (finished > 0u) {
+			std::cout << "Shader variants finished compiling: " << finished << '\n';
+			program_cache->print_stats();
+		}
 	}
 
 	void on_window_resize(signed int width, signed int height)
@@ -328,13 +791,47 @@ private:
 							puts("Hot reloading shaders...");
 							Util::clear_color();
 
-							glDeleteProgram(program);
-							create_shader();
+							shader_compiler->get_preprocessor().clear();
+							shader_variants->reload();
+							batch_variants->reload();
+							sprite_variants->reload();
+							packed_variants->reload();
 							break;
 
 						case SDL_SCANCODE_F1:
 							log_info();
 							break;
+
+						case SDL_SCANCODE_F2:
+							cycle_target_rate();
+							break;
+
+						case SDL_SCANCODE_F3:
+							frame_stats.print();
+							gpu_profiler->print();
+							mesh_pool->print_stats();
+							packed_pool->print_stats();
+							break;
+
+						case SDL_SCANCODE_F5:
+							toggle_stats_recording();
+							break;
+
+						case SDL_SCANCODE_F6:
+							cycle_shader_variant();
+							break;
+
+						case SDL_SCANCODE_F7:
+							toggle_grid();
+							break;
+
+						case SDL_SCANCODE_F8:
+							toggle_sprites();
+							break;
+
+						case SDL_SCANCODE_F9:
+							toggle_sphere();
+							break;
 					}
 					break;
 
@@ -352,14 +849,59 @@ private:
 
 };
 
-int main(int, char**)
+static ProgramOptions parse_options(int argc, char** argv)
 {
-	if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+	ProgramOptions options;
+
+	for (int i = 1; i < argc; ++i) {
+		auto value = [&]() -> const char* {
+			if (i + 1 >= argc) {
+				Util::throw_exception("Missing value for option", argv[i]);
+			}
+			return argv[++i];
+		};
+
+		if (std::strcmp(argv[i], "--headless") == 0) {
+			options.headless = true;
+		} else if (std::strcmp(argv[i], "--frames") == 0) {
+			const char* frames = value();
+			options.frame_count = static_cast<unsigned int>(std::stoul(frames));
+			if (options.frame_count == 0u) {
+				// The loop always renders the frame before checking the count, and the output needs a frame to read
+				Util::throw_exception("Frame count must be at least one", frames);
+			}
+		} else if (std::strcmp(argv[i], "--width") == 0) {
+			options.width = std::stoi(value());
+		} else if (std::strcmp(argv[i], "--height") == 0) {
+			options.height = std::stoi(value());
+		} else if (std::strcmp(argv[i], "--output") == 0) {
+			options.output_path = value();
+		} else {
+			Util::throw_exception("Unknown option", argv[i]);
+		}
+	}
+
+	return options;
+}
+
+int main(int argc, char** argv)
+{
+	ProgramOptions options;
+	try {
+		options = parse_options(argc, argv);
+	} catch (std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::cerr << "Usage: Working_Clean [--headless] [--frames N] [--width W] [--height H] [--output frame.ppm]\n";
+		return 1;
+	}
+
+	// Headless runs may have no display to initialize video against
+	if (SDL_Init(options.headless ? SDL_INIT_TIMER : SDL_INIT_VIDEO) != 0) {
 		std::cerr << "SDL Failed to init\n";
 	}
 
 	try {
-		Program().run();
+		Program(options).run();
 	} catch (std::exception& e) {
 		std::cerr << "Program panicked:\n" << e.what() << '\n';
 		SDL_Quit();
@@ -368,4 +910,4 @@ int main(int, char**)
 
 	SDL_Quit();
 	return 0;
-}
\ No newline at end of file
+}